@@ -16,46 +16,142 @@
 
 // local libraries
 #include <Message.h>
+#include <Layout.h>
+#include <Radio.h>
 
-#define SENSOR_NODE_NUM 10  // number of sensor nodes
+// number of sensor nodes, which have IDs 1 to SENSOR_NODE_NUM
+#define SENSOR_NODE_NUM LAYOUT_MAX_NODE_ID
 
 #define RF24_CE_PIN 6   // NRF24L01 CE pin assignment
 #define RF24_CSN_PIN 8  // NRF24L01 CSN pin assignment
+#define RF24_IRQ_PIN 2  // NRF24L01 IRQ pin assignment (must support external interrupts)
 
-// width in bytes of the radio's address
-#define RF24_ADDRESS_WIDTH 4
+// receive messages from the radio's IRQ instead of polling (0 to disable). Can
+// be set with -D in build_flags.
+#ifndef RF24_IRQ_ENABLED
+#define RF24_IRQ_ENABLED 1
+#endif
 
+// number of slots for buffering received messages in RAM (power of two)
+#define RX_QUEUE_SIZE 8
 
-class BaseStation {
+// keep the last known status of every node in EEPROM so it is shown right
+// away after a restart (0 to disable)
+#define EEPROM_STATE_ENABLED 1
+
+#if TDMA_ENABLED
+static_assert(1 == layout_num_sinks(), "TDMA requires a single sink");
+#endif
+
+// hardware settings of the base station's radio
+typedef RadioConfig<RF24_CE_PIN, RF24_CSN_PIN, RF24_IRQ_PIN, RF24_IRQ_ENABLED, RX_QUEUE_SIZE> base_station_radio_config_t;
+
+
+class BaseStation : public RadioNode<ROLE_SINK, base_station_radio_config_t> {
 
     private:
 
-        // unique id of the base station
-        uint8_t node_id = 0;
+        // bitmap to track sensor node vacancy statuses with one bit per node
+        uint8_t node_status[BITMAP_SIZE(SENSOR_NODE_NUM)] = {0};
+
+        // last sequence number applied for each node's status
+        SequenceCache<SENSOR_NODE_NUM> seen_sequences;
+
+        // nodes whose status has not been heard since startup or a request
+        // with one bit per node
+        uint8_t unsynced_nodes[BITMAP_SIZE(SENSOR_NODE_NUM)] = {0};
+
+        // number of queries sent since the last request
+        uint8_t num_queries = 0;
+
+        // time in milliseconds the most recent query was sent
+        uint32_t query_ms = 0;
+
+        // config from the host waiting to be sent into the network and the
+        // neighbors still to acknowledge it with one bit per egress index
+        ConfigMessage pending_config = ConfigMessage();
+        bool is_config_pending = false;
+        uint8_t config_egress = 0;
+
+        // number of times the config was sent and when it was last sent in milliseconds
+        uint8_t num_config_attempts = 0;
+        uint32_t config_ms = 0;
+
+        // nodes whose most recent status arrived through this sink rather
+        // than a peer sink with one bit per node
+        uint8_t region_nodes[BITMAP_SIZE(SENSOR_NODE_NUM)] = {0};
+
+        // statuses of the sink's region waiting to be shared with peer sinks
+        AggregateMessage pending_shares = AggregateMessage();
+
+        // time in milliseconds the oldest pending share was queued
+        uint32_t pending_shares_ms = 0;
 
-        // array to track sensor node statuses
-        bool node_status[SENSOR_NODE_NUM] = {0};
+        // time in milliseconds the whole region was last shared
+        uint32_t region_share_ms = 0;
 
-        // NRF24L01 transciever radio
-        RF24 radio = RF24(RF24_CE_PIN, RF24_CSN_PIN);
-        uint32_t radio_address = 0;
-        uint8_t radio_channel = 0;
+        // sequence number of the next snapshot of the region
+        uint8_t snapshot_sequence = SEQUENCE_RESTART;
+
+        // last sequence number applied for each peer sink's snapshots
+        SequenceCache<layout_num_sinks()> peer_snapshots;
 
         /**
-         * @brief Calculates a given node's radio address based on the node ID
+         * @brief Transmit a message to every peer sink
          * 
-         * @param node_id: ID of node to calculate address for
-         * @return The calculated radio address for the node
+         * @param msg: Message to be transmitted
+         * @param size: Number of bytes of the message to transmit
+         * @return True if every peer sink received it. Otherwise false
          */
-        uint32_t calculate_radio_address(uint8_t node_id);
+        bool transmit_to_peers(Message* msg, uint8_t size);
+
+        /**
+         * @brief Sends a snapshot of every status of the sink's region to peer sinks
+         * 
+         * @return True if every peer sink received it. Otherwise false
+         */
+        bool transmit_region_snapshot();
+
+#if EEPROM_STATE_ENABLED
+        // statuses in the most recent EEPROM record
+        uint8_t persisted_status[BITMAP_SIZE(SENSOR_NODE_NUM)] = {0};
+
+        // EEPROM slot of the most recent record and its write count
+        uint8_t state_slot = 0;
+        uint16_t state_count = 0;
+
+        // time in milliseconds the most recent record was written
+        uint32_t persist_ms = 0;
+
+        /**
+         * @brief Loads the statuses of the most recent EEPROM record
+         * 
+         * @return True if a valid record was found. Otherwise false
+         */
+        bool restore_state();
+#endif
+
+#if TDMA_ENABLED
+        // sequence number of the most recent beacon
+        uint8_t beacon_sequence = 0;
+
+        // time in milliseconds the most recent beacon was sent
+        uint32_t beacon_ms = 0;
+#endif
 
         /**
-         * @brief Calculates a given node's radio channel based on the node ID
+         * @brief Transmit a message to a neighboring sensor node
          * 
-         * @param node_id: ID of node to calculate channel for
-         * @return The calculated radio channel for the node (0-125)
+         * @param msg: Message to be transmitted
+         * @param size: Number of bytes of the message to transmit
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_message(Message* msg, uint8_t size);
+
+        /**
+         * @brief Stores the current radio settings in EEPROM
          */
-        uint8_t calculate_radio_channel(uint8_t node_id);
+        void store_radio_settings();
 
 
     public:
@@ -76,27 +172,148 @@ class BaseStation {
         bool init();
 
         /**
-         * @brief Determine if there is a message available to read
+         * @brief Determines if it is time to start a new superframe with a beacon
+         * 
+         * @return True if a beacon is due. Otherwise false
+         */
+        bool is_beacon_due();
+
+        /**
+         * @brief Gets the time until the next beacon is due
+         * 
+         * @return Time in milliseconds
+         */
+        uint32_t get_time_until_beacon();
+
+        /**
+         * @brief Broadcasts a beacon starting a new TDMA superframe
+         * 
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_beacon();
+
+        /**
+         * @brief Asks for a node's status to be pulled with the next query
+         * 
+         * Every node is requested on initialization so the lot is resynced
+         * without waiting for heartbeats.
          * 
-         * @return True if a message is available. Otherwise false
+         * @param node_id: ID of node whose status is needed
+         * @return True if the node ID is valid. Otherwise false
          */
-        bool is_message();
+        bool request_status(uint8_t node_id);
 
         /**
-         * @brief Gets a message from the message queue
+         * @brief Determines if requested statuses should be queried
          * 
-         * @param buffer: buffer to hold message
-         * @param size: size of buffer
-         * @return Number of bytes read
+         * Queries repeat every QUERY_RETRY_MS until every requested node has
+         * reported or QUERY_MAX_ATTEMPTS were sent.
+         * 
+         * @return True if a query is due. Otherwise false
          */
-        bool read_message(uint8_t** buffer, uint8_t size);
+        bool is_query_due();
 
         /**
-         * @brief Get the ID of the node
+         * @brief Sends a query for every requested status into the network
          * 
-         * @return ID of the node
+         * @return True if any neighboring node received it. Otherwise false
          */
-        uint8_t get_id();
+        bool transmit_query();
+
+        /**
+         * @brief Holds a config from the host to be sent into the network
+         * 
+         * @param msg: config to send, whose receiver is set for each neighbor
+         */
+        void queue_config(ConfigMessage* msg);
+
+        /**
+         * @brief Determines if a config from the host is waiting to be sent
+         * 
+         * The config is sent again every CONFIG_RETRY_MS until every
+         * neighboring node acknowledged it or CONFIG_MAX_ATTEMPTS were sent.
+         * 
+         * @return True if a config is due. Otherwise false
+         */
+        bool is_config_due();
+
+        /**
+         * @brief Sends the held config to every neighboring node that has not
+         *      acknowledged it yet
+         * 
+         * Neighbors pass it on to the nodes routed through them. Once every
+         * neighbor has it, a config for every node is applied to the base
+         * station's radio, so it stays on the same data rate as the network,
+         * and is stored in EEPROM. The base station keeps its radio settings
+         * if any neighbor never acknowledged it.
+         * 
+         * @return True if every neighboring node has received it. Otherwise false
+         */
+        bool transmit_config();
+
+        /**
+         * @brief Determines if a node is another sink of the lot
+         * 
+         * @param node_id: node ID to be evaluated
+         * @return True if the node is a sink other than this one. Otherwise false
+         */
+        bool is_peer_sink(uint8_t node_id);
+
+        /**
+         * @brief Records where a new status came from and queues it for peer sinks
+         * 
+         * Statuses that arrive through this sink's region are shared with every
+         * peer sink, statuses from peer sinks are only applied.
+         * 
+         * @param node_id: ID of node reporting its status
+         * @param is_vacant: Node's vacancy status
+         * @param sequence: Node's sequence number for the status
+         * @param tx_id: ID of node the status was received from
+         */
+        void share_status(uint8_t node_id, bool is_vacant, uint8_t sequence, uint8_t tx_id);
+
+        /**
+         * @brief Determines if statuses should be shared with peer sinks
+         * 
+         * Shares are ready once the oldest has waited SHARE_WINDOW_MS or no
+         * more fit, and the whole region is shared every SHARE_REGION_INTERVAL_MS.
+         * Never ready with a single sink.
+         * 
+         * @return True if shares are ready. Otherwise false
+         */
+        bool is_share_due();
+
+        /**
+         * @brief Sends the pending shares, and the whole region when due, to peer sinks
+         * 
+         * Pending shares go out as aggregate messages and are cleared
+         * regardless of transmission success. The whole region follows them
+         * as snapshot messages, so it is never older than a share before it.
+         * 
+         * @return True if every peer sink received them. Otherwise false
+         */
+        bool transmit_shares();
+
+        /**
+         * @brief Determines if a snapshot is newer than the last one applied from its sink
+         * 
+         * A new snapshot is recorded, so later duplicates of it are rejected.
+         * 
+         * @param sink_id: ID of peer sink that sent the snapshot
+         * @param sequence: sink's sequence number for the snapshot
+         * @return True if the snapshot is new. False if it is a duplicate or stale
+         */
+        bool is_new_snapshot(uint8_t sink_id, uint8_t sequence);
+
+        /**
+         * @brief Determines if a node's most recent status arrived through this sink
+         * 
+         * Snapshots of peer sinks do not replace such statuses.
+         * 
+         * @param node_id: ID of node to be checked
+         * @return True if the node reports through this sink. Otherwise false
+         */
+        bool is_region_node(uint8_t node_id);
 
         /**
          * @brief Determines if the provided node ID is valid
@@ -106,6 +323,18 @@ class BaseStation {
          */
         bool is_valid_sensor_node(uint8_t node_id);
 
+        /**
+         * @brief Determines if a status is newer than the last one applied for a node
+         * 
+         * A new status is recorded, so later duplicates of it are rejected and
+         * the node no longer needs to be queried.
+         * 
+         * @param node_id: ID of node reporting its status
+         * @param sequence: Node's sequence number for the status
+         * @return True if the status is new. False if it is a duplicate or stale
+         */
+        bool is_new_status(uint8_t node_id, uint8_t sequence);
+
         /**
          * @brief Update the vacancy status of a node
          * 
@@ -123,6 +352,29 @@ class BaseStation {
          */
         bool get_node_status(uint8_t node_id);
 
+        /**
+         * @brief Determines if a node's status was heard since startup or the
+         *      last request for it
+         * 
+         * Statuses restored from EEPROM stay unconfirmed until their node
+         * answers the resync query.
+         * 
+         * @param node_id: ID of node to be checked
+         * @return True if the status is confirmed. Otherwise false
+         */
+        bool is_node_synced(uint8_t node_id);
+
+        /**
+         * @brief Writes the statuses of every node to EEPROM if they changed
+         * 
+         * Changes are coalesced into at most one write every PERSIST_INTERVAL_MS
+         * and each write goes to the next of EEPROM_STATE_SLOTS slots to
+         * spread wear. Does nothing unless EEPROM_STATE_ENABLED.
+         * 
+         * @return True if a record was written. Otherwise false
+         */
+        bool persist_state();
+
         /**
          * @brief Counts the number of nodes with vacant status
          * 
@@ -24,11 +24,31 @@ bool init_parking_display();
 void draw_parking_map();
 
 /**
- * @brief Draws or erases a car in a particular parking space
+ * @brief Marks a car in a particular parking space to be drawn or erased
+ * 
+ * The space is drawn by the next call to render_parking_display(). A space
+ * whose status is unconfirmed is drawn as a hollow car if occupied and as a
+ * dot if vacant.
  * 
  * @param space_id: ID of parking space to update
  * @param is_vacant: vacancy status of parking space
+ * @param is_confirmed: if the status was heard from the space's node
+ */
+void update_parking_space(uint8_t space_id, bool is_vacant, bool is_confirmed);
+
+/**
+ * @brief Determines if any parking spaces are waiting to be drawn
+ * 
+ * @return True if a parking space needs to be drawn. Otherwise false
+ */
+bool is_parking_display_dirty();
+
+/**
+ * @brief Draws all parking spaces marked by update_parking_space()
+ * 
+ * Does nothing unless vertical blanking started since the last render, so
+ * the display is drawn at most once per frame.
  */
-void update_parking_space(uint8_t space_id, bool is_vacant);
+void render_parking_display();
 
 #endif // _PARKING_DISPLAY_HPP_
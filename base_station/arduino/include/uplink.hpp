@@ -0,0 +1,163 @@
+/**
+* @brief: Contains the prototype of the Uplink class.
+* @file: uplink.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _UPLINK_HPP_
+#define _UPLINK_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local libraries
+#include <Message.h>
+
+// local dependencies
+#include "basestation.hpp"
+
+
+// stream the lot state to a host over serial as binary frames (0 to disable)
+#define UPLINK_ENABLED 1
+
+// Every frame is COBS encoded and surrounded by 0x00 delimiters, so a host can
+// resynchronize at any delimiter and discard any text logged in between. The
+// decoded frame is: type, sequence number, payload, CRC-8 of everything before.
+
+#define UPLINK_STATUS 1     // status change of one node (payload: node ID, is vacant, is confirmed)
+#define UPLINK_SNAPSHOT 2   // status of every node (payload: number of nodes, vacancy bitmap,
+                            // unconfirmed bitmap)
+#define UPLINK_DUMP 3       // host request for a snapshot (no payload)
+#define UPLINK_STATS 4      // counters of one node (payload: node ID, number of counters, counters LSB first)
+#define UPLINK_TRACE 5      // hops of a traced status (payload: origin ID, sequence number, number of hops,
+                            // then each hop's node ID and milliseconds held LSB first)
+#define UPLINK_QUERY 6      // host request to pull the status of a node (payload: node ID or 0 for every node)
+#define UPLINK_CONFIG 7     // host config for the network (payload: target node ID or 0xFF for every node,
+                            // version, then config_settings_t)
+
+// A status is unconfirmed while it was restored from EEPROM or requested by the
+// host and not heard from its node since, so the host can show it as stale.
+
+// decoded frame sizes in bytes including type, sequence number and CRC
+#define UPLINK_SNAPSHOT_FRAME_SIZE (4 + (2 * BITMAP_SIZE(SENSOR_NODE_NUM)))
+#define UPLINK_STATS_FRAME_SIZE (5 + (2 * STATS_MAX_COUNTERS))
+#define UPLINK_TRACE_FRAME_SIZE (6 + (3 * TRACE_MAX_HOPS))
+#define UPLINK_CONFIG_FRAME_SIZE (5 + sizeof(config_settings_t))
+
+// largest decoded frame in bytes
+#define UPLINK_MAX_FRAME_SIZE ((UPLINK_SNAPSHOT_FRAME_SIZE > UPLINK_STATS_FRAME_SIZE) ? UPLINK_SNAPSHOT_FRAME_SIZE : UPLINK_STATS_FRAME_SIZE)
+
+// largest encoded frame in bytes including delimiters
+#define UPLINK_MAX_ENCODED_SIZE (COBS_ENCODED_SIZE(UPLINK_MAX_FRAME_SIZE) + 2)
+
+static_assert(UPLINK_MAX_FRAME_SIZE >= UPLINK_TRACE_FRAME_SIZE, "trace frames must fit in the largest frame");
+static_assert(UPLINK_MAX_FRAME_SIZE >= UPLINK_CONFIG_FRAME_SIZE, "config frames must fit in the largest frame");
+
+
+class Uplink {
+
+    private:
+
+        // base station whose state is streamed
+        BaseStation* base_station = NULL;
+
+        // sequence number of the next frame sent
+        uint8_t sequence = 0;
+
+        // time in milliseconds the last snapshot was sent
+        uint32_t snapshot_ms = 0;
+
+        // time in milliseconds the base station's own stats were last sent
+        uint32_t stats_ms = 0;
+
+        // encoded frame being received from the host
+        uint8_t rx_frame[UPLINK_MAX_ENCODED_SIZE];
+        uint8_t rx_size = 0;
+
+        // number of frames dropped because the serial buffer was full
+        uint16_t num_dropped = 0;
+
+        /**
+         * @brief Frames, encodes and queues a frame for sending to the host
+         * 
+         * Does not block. The frame is dropped if it does not fit in the
+         * serial transmit buffer.
+         * 
+         * @param type: type of frame
+         * @param payload: bytes following the sequence number
+         * @param size: number of bytes in payload
+         * @return True if the frame was queued. Otherwise false
+         */
+        bool send_frame(uint8_t type, const uint8_t* payload, uint8_t size);
+
+        /**
+         * @brief Handles a complete encoded frame received from the host
+         * 
+         * @param frame: encoded frame without delimiters
+         * @param size: number of bytes in frame
+         */
+        void handle_frame(uint8_t* frame, uint8_t size);
+
+
+    public:
+
+        /**
+         * @brief Constructs an Uplink object
+         * 
+         * @param base_station: base station whose state is streamed
+         */
+        Uplink(BaseStation* base_station);
+
+        /**
+         * @brief Sends the status change of a node to the host
+         * 
+         * @param node_id: ID of node whose status changed
+         * @param is_vacant: Node's vacancy status
+         * @param is_confirmed: if the status was heard from the node since
+         *      startup or the last request
+         * @return True if the frame was queued. Otherwise false
+         */
+        bool send_status(uint8_t node_id, bool is_vacant, bool is_confirmed);
+
+        /**
+         * @brief Sends the status of every node to the host
+         * 
+         * @return True if the frame was queued. Otherwise false
+         */
+        bool send_snapshot();
+
+        /**
+         * @brief Sends the counters of a node to the host
+         * 
+         * @param node_id: ID of node the counters belong to
+         * @param counters: counter values
+         * @param num_counters: number of counters (at most STATS_MAX_COUNTERS)
+         * @return True if the frame was queued. Otherwise false
+         */
+        bool send_stats(uint8_t node_id, const uint16_t* counters, uint8_t num_counters);
+
+        /**
+         * @brief Sends the hops of a traced status to the host
+         * 
+         * @param msg: trace message received by the base station
+         * @return True if the frame was queued. Otherwise false
+         */
+        bool send_trace(TraceMessage* msg);
+
+        /**
+         * @brief Handles requests from the host and sends periodic snapshots
+         *      and stats of the base station
+         */
+        void update();
+
+        /**
+         * @brief Gets the number of frames dropped because the serial buffer was full
+         * 
+         * @return Number of dropped frames
+         */
+        uint16_t get_num_dropped();
+};
+
+
+#endif // _UPLINK_HPP_
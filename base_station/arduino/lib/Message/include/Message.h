@@ -1,14 +0,0 @@
-/**
-* @brief: Includes all required headers for the Message library
-* @file: Message.h
-*
-* @author: jkieltyka15
-*/
-
-#ifndef _MESSAGE_H_
-#define _MESSAGE_H_
-
-#include "message.hpp"
-#include "updatemessage.hpp"
-
-#endif // _MESSAGE_H_
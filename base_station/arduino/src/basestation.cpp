@@ -7,10 +7,12 @@
 
 // standard libraries
 #include <Arduino.h>
+#include <EEPROM.h>
 #include <stdlib.h>
 #include <Wire.h>
 
 // local libraries
+#include <Counters.h>
 #include <Log.h>
 #include <Message.h>
 
@@ -18,108 +20,547 @@
 #include "basestation.hpp"
 
 
-// base station's node ID
-#define BASE_STATION_ID 0
+#define BEACON_PHASE_MS 30  // time at the start of a superframe for relaying beacons
+#define TDMA_SLOT_MS 20     // length of each sensor node's transmit slot
 
-// special base station address since 0x00000000 is not a valid address
-#define BASE_STATION_ADDRESS 0xBAD1DEA5
+// length of a superframe with one slot per sensor node in milliseconds
+#define SUPERFRAME_MS (BEACON_PHASE_MS + (SENSOR_NODE_NUM * TDMA_SLOT_MS))
 
-#define RF24_CHANNEL_SPACING 5  // number of channels between a valid node channel
-#define RF24_READING_PIPE 1     // reading pipe for the NRF24L01
+#define QUERY_RETRY_MS 2000     // time between queries for statuses not yet heard
+#define QUERY_MAX_ATTEMPTS 5    // queries sent before waiting for heartbeats instead
 
-#define MAX_SEND_ATTEMPTS 15    // maximum number of attempts to send a message
-#define FAILED_SEND_DELAY 15    // minimum delay between sending message attempts
+// number of grid cells next to the base station
+#define NUM_EGRESS_NODES LAYOUT_NUM_NEIGHBORS
 
+#define SHARE_WINDOW_MS 250             // longest time a status waits to be shared with peer sinks
+#define SHARE_REGION_INTERVAL_MS 10000  // time between sharing every status of the sink's region
 
-BaseStation::BaseStation(uint8_t node_id) {
+#define EEPROM_STATE_ADDRESS 0  // EEPROM address of the first lot state slot
+#define EEPROM_STATE_SLOTS 64   // number of slots lot state records rotate through
+#define PERSIST_INTERVAL_MS 10000   // minimum time between lot state writes
 
-    this->node_id = node_id;
+// EEPROM address of the config sent over the air, after the lot state slots
+#define EEPROM_CONFIG_ADDRESS (EEPROM_STATE_ADDRESS + (EEPROM_STATE_SLOTS * sizeof(state_record_t)))
 
-    this->radio_address = this->calculate_radio_address(node_id);
-    this->radio_channel = this->calculate_radio_channel(node_id);
+
+// lot state stored in each EEPROM slot
+struct MESSAGE_PACKED state_record_t {
+    uint16_t count;                                     // number of records written before this one
+    uint8_t node_status[BITMAP_SIZE(SENSOR_NODE_NUM)];  // vacancy status with one bit per node
+    uint8_t crc;                                        // CRC-8 of everything before
+};
+
+static_assert(E2END + 1 >= EEPROM_CONFIG_ADDRESS + sizeof(config_record_t),
+              "lot state slots and config must fit in EEPROM");
+
+
+BaseStation::BaseStation(uint8_t node_id) : RadioNode(node_id) {
+
+    this->pending_shares = AggregateMessage(node_id, node_id);
 }
 
 
-uint32_t BaseStation::calculate_radio_address(uint8_t node_id) {
+bool BaseStation::init() {
+
+    // stay on the radio settings last sent to the network
+    ConfigMessage config = ConfigMessage();
+    if (true == BaseStation::load_config(EEPROM_CONFIG_ADDRESS, &config)) {
+        this->config_version = config.get_version();
+        this->set_radio_settings(config.get_settings());
+    }
+
+    // start radio
+    if (false == this->init_radio()) {
+
+        ERROR("Failed to start radio")
+        return false;
+    }
 
-    // base station has special non-calculated address
-    if (BASE_STATION_ID == node_id) {
-        return BASE_STATION_ADDRESS;
+    // assuming status of all sensor nodes are vacant on initialization
+    // until they answer the first query
+    for (uint8_t i = 0; i < SENSOR_NODE_NUM; i++) {
+        bitmap_set(this->node_status, i, this->is_valid_sensor_node(i + 1));
+        (void) this->request_status(i + 1);
     }
 
-    // generate address as byte array
-    const byte address_bytes[RF24_ADDRESS_WIDTH] = { node_id, node_id, node_id, node_id };
+#if EEPROM_STATE_ENABLED
+    // start from the last known state, which stays stale until each node
+    // answers the resync query
+    if (true == this->restore_state()) {
+        INFO("Restored lot state from EEPROM")
+    }
+#endif
 
-    // convert byte array to 32 bit integer
-    uint32_t address = 0;
-    memcpy(&address, address_bytes, sizeof(address));
-    
-    return address; 
+    return true;
 }
 
 
-uint8_t BaseStation::calculate_radio_channel(uint8_t node_id) {
+bool BaseStation::is_beacon_due() {
 
-    return node_id * RF24_CHANNEL_SPACING;
+    return 0 == this->get_time_until_beacon();
 }
 
 
-bool BaseStation::init() {
+uint32_t BaseStation::get_time_until_beacon() {
 
-    // start radio
-    if (false == radio.begin()) {
+#if TDMA_ENABLED
+    uint32_t elapsed_ms = millis() - this->beacon_ms;
 
-        ERROR("Failed to start radio")
-        return false;
+    if (SUPERFRAME_MS <= elapsed_ms) {
+        return 0;
     }
 
-    // configure radio
-    radio.enableDynamicPayloads();
-    radio.setAutoAck(true);
-    radio.setRetries(FAILED_SEND_DELAY, MAX_SEND_ATTEMPTS);
-    radio.setAddressWidth(RF24_ADDRESS_WIDTH);
-    radio.setPALevel(RF24_PA_MAX);
-    radio.setChannel(this->radio_channel);
-    radio.openReadingPipe(RF24_READING_PIPE, this->radio_address);
+    return SUPERFRAME_MS - elapsed_ms;
+#else
+    return UINT32_MAX;
+#endif
+}
+
 
-    // start listening on radio
-    radio.startListening();
+bool BaseStation::transmit_beacon() {
 
-    // assuming status of all sensor nodes are vacant on initialization
-    for (uint8_t i; i < sizeof(this->node_status); i++) {
-        this->node_status[i] = true;
+#if TDMA_ENABLED
+    this->beacon_ms = millis();
+    this->beacon_sequence++;
+
+    BeaconMessage msg = BeaconMessage(this->node_id,
+                                      this->beacon_sequence,
+                                      BEACON_PHASE_MS,
+                                      TDMA_SLOT_MS,
+                                      SENSOR_NODE_NUM,
+                                      0);
+
+#if RF24_IRQ_ENABLED
+    this->begin_radio_access();
+#endif
+
+    this->radio.stopListening();
+    this->radio.openWritingPipe(BROADCAST_ADDRESS);
+
+    // attempt to transmit message without waiting for an acknowledgement
+    COUNTER_INC(COUNTER_TX_ATTEMPTS);
+    bool is_sent = this->radio.write(&msg, sizeof(msg), true);
+
+    if (false == is_sent) {
+        COUNTER_INC(COUNTER_TX_FAILURES);
     }
 
-    return true;
+    // start listening again
+    this->radio.startListening();
+
+#if RF24_IRQ_ENABLED
+    this->end_radio_access();
+#endif
+
+    return is_sent;
+#else
+    return false;
+#endif
 }
 
 
-bool BaseStation::is_message() {
+bool BaseStation::transmit_message(Message* msg, uint8_t size) {
+
+    uint8_t rx_id = msg->get_rx_id();
+    uint8_t rx_channel = this->calculate_radio_channel(rx_id);
+    bool is_shared_channel = (rx_channel == this->radio_channel);
+
+#if RF24_IRQ_ENABLED
+    this->begin_radio_access();
+#endif
+
+    this->radio.stopListening();
+
+    // switch to receiver node's channel if it is not shared
+    if (false == is_shared_channel) {
+        this->radio.setChannel(rx_channel);
+    }
+
+    this->radio.openWritingPipe(this->calculate_tx_address(rx_id));
+
+    // attempt to transmit message
+    COUNTER_INC(COUNTER_TX_ATTEMPTS);
+    size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+    bool is_sent = this->radio.write(msg, size);
+
+    if (false == is_sent) {
+        COUNTER_INC(COUNTER_TX_FAILURES);
+    }
+
+    // switch back to the base station's channel
+    if (false == is_shared_channel) {
+        this->radio.setChannel(this->radio_channel);
+    }
+
+    // start listening again
+    this->radio.startListening();
+
+#if RF24_IRQ_ENABLED
+    this->end_radio_access();
+#endif
+
+    // a neighbor heard the base station on its new radio settings
+    if (true == is_sent) {
+        this->confirm_radio_settings();
+    }
 
-    return this->radio.available();
+    // nothing got through on the new radio settings, so go back to the old ones
+    else if (true == this->is_radio_fallback_due()) {
+        WARN("No node acknowledged new radio settings. Reverted to config version %d", this->fallback_version)
+        this->fall_back_radio_settings();
+        this->store_radio_settings();
+    }
+
+    return is_sent;
+}
+
+
+/**
+ * @brief Gets a sensor node next to a base station
+ * 
+ * Nodes next to a base station on the routing grid are the only ones that
+ * can forward to it directly, so messages into the network start with them.
+ * 
+ * @param sink_id: ID of the base station
+ * @param index: index of the neighbor (0 to NUM_EGRESS_NODES - 1)
+ * @return ID of the node. Otherwise LAYOUT_NONE
+ */
+static uint8_t get_egress_node(uint8_t sink_id, uint8_t index) {
+
+    uint8_t node_id = layout_read_neighbor(sink_id, index);
+
+    // sinks do not forward
+    if (true == layout_read_is_sink(node_id)) {
+        return LAYOUT_NONE;
+    }
+
+    return node_id;
 }
 
 
-bool BaseStation::read_message(uint8_t** buffer, uint8_t len) {
+bool BaseStation::request_status(uint8_t node_id) {
 
-    if (false == this->radio.available()) {
+    // provided node id is not valid
+    if (false == this->is_valid_sensor_node(node_id)) {
         return false;
     }
 
-    this->radio.read(buffer, len);
+    bitmap_set(this->unsynced_nodes, node_id - 1, true);
+
+    // start over so the new request gets every attempt right away
+    this->num_queries = 0;
+    this->query_ms = millis() - QUERY_RETRY_MS;
+
     return true;
 }
 
 
-uint8_t BaseStation::get_id() {
+bool BaseStation::is_query_due() {
 
-    return this->node_id;
+    // every requested node has reported or gave no answer
+    if (QUERY_MAX_ATTEMPTS <= this->num_queries
+        || 0 == bitmap_count(this->unsynced_nodes, SENSOR_NODE_NUM)) {
+
+        return false;
+    }
+
+    return QUERY_RETRY_MS <= (millis() - this->query_ms);
+}
+
+
+bool BaseStation::transmit_query() {
+
+    this->query_ms = millis();
+    this->num_queries++;
+
+    // receiver is set for each neighbor below
+    QueryMessage msg = QueryMessage(this->node_id, this->node_id, 1, SENSOR_NODE_NUM);
+
+    for (uint8_t i = 0; i < SENSOR_NODE_NUM; i++) {
+        (void) msg.set_is_queried(i + 1, bitmap_get(this->unsynced_nodes, i));
+    }
+
+    bool is_sent = false;
+
+    // every neighbor gets the whole query and only passes on the targets
+    // routed through it
+    for (uint8_t i = 0; i < NUM_EGRESS_NODES; i++) {
+
+        uint8_t rx_id = get_egress_node(this->node_id, i);
+
+        if (LAYOUT_NONE == rx_id) {
+            continue;
+        }
+
+        msg.set_rx_id(rx_id);
+
+        if (true == this->transmit_message(&msg, msg.get_size())) {
+            is_sent = true;
+        }
+    }
+
+    return is_sent;
+}
+
+
+void BaseStation::queue_config(ConfigMessage* msg) {
+
+    this->pending_config = *msg;
+    this->is_config_pending = true;
+    this->config_egress = 0;
+
+    // every neighbor gets the config and only passes it on to the nodes
+    // routed through it
+    for (uint8_t i = 0; i < NUM_EGRESS_NODES; i++) {
+
+        if (LAYOUT_NONE != get_egress_node(this->node_id, i)) {
+            this->config_egress |= (1 << i);
+        }
+    }
+
+    // send right away
+    this->num_config_attempts = 0;
+    this->config_ms = millis() - CONFIG_RETRY_MS;
+}
+
+
+bool BaseStation::is_config_due() {
+
+    return true == this->is_config_pending && CONFIG_RETRY_MS <= (millis() - this->config_ms);
+}
+
+
+bool BaseStation::transmit_config() {
+
+    this->config_ms = millis();
+    this->num_config_attempts++;
+
+    // neighbors that acknowledged it are not sent it again
+    for (uint8_t i = 0; i < NUM_EGRESS_NODES; i++) {
+
+        if (0 == (this->config_egress & (1 << i))) {
+            continue;
+        }
+
+        this->pending_config.set_rx_id(get_egress_node(this->node_id, i));
+
+        bool is_sent = this->transmit_message(&this->pending_config, sizeof(this->pending_config));
+
+        // neighbor may have missed only the acknowledgement and switched already
+        if (false == is_sent && true == this->try_radio_settings(this->pending_config.get_settings())) {
+            is_sent = this->transmit_message(&this->pending_config, sizeof(this->pending_config));
+            this->apply_radio_settings();
+        }
+
+        if (true == is_sent) {
+            this->config_egress &= ~(1 << i);
+        }
+    }
+
+    bool is_received = (0 == this->config_egress);
+
+    // retry the neighbors that missed it
+    if (false == is_received && CONFIG_MAX_ATTEMPTS > this->num_config_attempts) {
+        return false;
+    }
+
+    this->is_config_pending = false;
+
+    // follow the network onto its new radio settings only once every
+    // neighbor has them, so the base station is never cut off from it
+    if (true == is_received && BROADCAST_ID == this->pending_config.get_target_id()) {
+        this->switch_radio_settings(this->pending_config.get_settings(), this->pending_config.get_version());
+        this->store_radio_settings();
+    }
+
+    return is_received;
+}
+
+
+void BaseStation::store_radio_settings() {
+
+    // store every current radio setting so a later partial config keeps the others
+    config_settings_t settings;
+    memset(&settings, CONFIG_KEEP, sizeof(settings));
+    settings.max_send_attempts = this->max_send_attempts;
+    settings.failed_send_delay = this->failed_send_delay;
+    settings.pa_level = this->max_pa_level;
+    settings.data_rate = this->data_rate;
+
+    ConfigMessage record = ConfigMessage(this->node_id, this->node_id, BROADCAST_ID, this->config_version, settings);
+    BaseStation::store_config(EEPROM_CONFIG_ADDRESS, &record);
 }
 
 
 bool BaseStation::is_valid_sensor_node(uint8_t node_id) {
 
-    return node_id <= SENSOR_NODE_NUM && node_id != this->node_id;
+    return node_id <= SENSOR_NODE_NUM && node_id != this->node_id && false == layout_read_is_sink(node_id);
+}
+
+
+bool BaseStation::is_peer_sink(uint8_t node_id) {
+
+    return node_id != this->node_id && true == layout_read_is_sink(node_id);
+}
+
+
+void BaseStation::share_status(uint8_t node_id, bool is_vacant, uint8_t sequence, uint8_t tx_id) {
+
+    // provided node id is not valid
+    if (false == this->is_valid_sensor_node(node_id)) {
+        return;
+    }
+
+    // node now reports through the peer sink, which shares it
+    if (true == this->is_peer_sink(tx_id)) {
+        bitmap_set(this->region_nodes, node_id - 1, false);
+        return;
+    }
+
+    bitmap_set(this->region_nodes, node_id - 1, true);
+
+    // no peer sinks to share with
+    if constexpr (1 >= layout_num_sinks()) {
+        return;
+    }
+
+    // start share window with first pending share
+    if (0 == this->pending_shares.get_num_entries()) {
+        this->pending_shares_ms = millis();
+    }
+
+    // the next region share covers it
+    if (false == this->pending_shares.add_entry(node_id, is_vacant, sequence)) {
+        COUNTER_INC(COUNTER_DROPS);
+    }
+}
+
+
+bool BaseStation::is_share_due() {
+
+    // no peer sinks to share with
+    if constexpr (1 >= layout_num_sinks()) {
+        return false;
+    }
+
+    if (SHARE_REGION_INTERVAL_MS <= (millis() - this->region_share_ms)) {
+        return true;
+    }
+
+    return 0 < this->pending_shares.get_num_entries()
+        && (true == this->pending_shares.is_full() || SHARE_WINDOW_MS <= (millis() - this->pending_shares_ms));
+}
+
+
+bool BaseStation::transmit_shares() {
+
+    bool is_sent = true;
+
+    if (0 < this->pending_shares.get_num_entries()) {
+        is_sent = this->transmit_to_peers(&this->pending_shares, this->pending_shares.get_size());
+        this->pending_shares.clear();
+    }
+
+    // share every status of the region in case earlier shares were lost
+    if (SHARE_REGION_INTERVAL_MS <= (millis() - this->region_share_ms)) {
+        this->region_share_ms = millis();
+        is_sent = this->transmit_region_snapshot() && is_sent;
+    }
+
+    return is_sent;
+}
+
+
+bool BaseStation::transmit_region_snapshot() {
+
+    bool is_sent = true;
+
+    // one snapshot per range of nodes that fits in a message
+    for (uint16_t first_id = 1; first_id <= SENSOR_NODE_NUM; first_id += SNAPSHOT_MAX_NODES) {
+
+        uint8_t num_nodes = min((uint16_t)(SENSOR_NODE_NUM + 1 - first_id), (uint16_t)SNAPSHOT_MAX_NODES);
+        SnapshotMessage msg = SnapshotMessage(this->node_id, this->node_id, this->snapshot_sequence,
+                                              (uint8_t)first_id, num_nodes);
+        bool is_empty = true;
+
+        // only statuses heard through this sink, peers have their own
+        for (uint16_t id = first_id; id < first_id + num_nodes; id++) {
+
+            if (true == this->is_region_node(id)) {
+                (void) msg.set_is_vacant(id, this->get_node_status(id));
+                is_empty = false;
+            }
+        }
+
+        if (true == is_empty) {
+            continue;
+        }
+
+        this->snapshot_sequence = sequence_next(this->snapshot_sequence);
+        is_sent = this->transmit_to_peers(&msg, msg.get_size()) && is_sent;
+    }
+
+    return is_sent;
+}
+
+
+bool BaseStation::transmit_to_peers(Message* msg, uint8_t size) {
+
+    bool is_sent = true;
+
+    for (uint8_t sink_id = 0; sink_id <= LAYOUT_MAX_NODE_ID; sink_id++) {
+
+        if (false == this->is_peer_sink(sink_id)) {
+            continue;
+        }
+
+        msg->set_rx_id(sink_id);
+
+        if (false == this->transmit_message(msg, size)) {
+            is_sent = false;
+        }
+    }
+
+    return is_sent;
+}
+
+
+bool BaseStation::is_new_snapshot(uint8_t sink_id, uint8_t sequence) {
+
+    // only peer sinks send snapshots
+    if (false == this->is_peer_sink(sink_id)) {
+        return false;
+    }
+
+    return this->peer_snapshots.accept(sink_id, sequence);
+}
+
+
+bool BaseStation::is_region_node(uint8_t node_id) {
+
+    // provided node id is not valid
+    if (false == this->is_valid_sensor_node(node_id)) {
+        return false;
+    }
+
+    return bitmap_get(this->region_nodes, node_id - 1);
+}
+
+
+bool BaseStation::is_new_status(uint8_t node_id, uint8_t sequence) {
+
+    // invalid nodes are not tracked
+    if (false == this->is_valid_sensor_node(node_id)) {
+        return true;
+    }
+
+    // node's status is heard so it no longer needs to be queried
+    if (true == this->seen_sequences.accept(node_id, sequence)) {
+        bitmap_set(this->unsynced_nodes, node_id - 1, false);
+        return true;
+    }
+
+    return false;
 }
 
 
@@ -130,7 +571,7 @@ bool BaseStation::update_node_status(uint8_t node_id, bool is_vacant) {
         return false;
     }
 
-    this->node_status[node_id - 1] = is_vacant;
+    bitmap_set(this->node_status, node_id - 1, is_vacant);
 
     return true;
 }
@@ -142,22 +583,88 @@ bool BaseStation::get_node_status(uint8_t node_id) {
         return false;
     }
 
-    return this->node_status[node_id - 1];
+    return bitmap_get(this->node_status, node_id - 1);
 }
 
 
-uint8_t BaseStation::num_vacant() {
+bool BaseStation::is_node_synced(uint8_t node_id) {
 
-    uint8_t num_vacant = 0;
+    // provided node id is not valid
+    if (false == this->is_valid_sensor_node(node_id)) {
+        return false;
+    }
 
-    // count number of vacant statuses
-    for (uint8_t i = 0; i < sizeof(this->node_status); i++) {
+    return false == bitmap_get(this->unsynced_nodes, node_id - 1);
+}
 
-        // status is vacant
-        if (true == node_status[i]) {
-            num_vacant++;
+
+#if EEPROM_STATE_ENABLED
+bool BaseStation::restore_state() {
+
+    bool is_found = false;
+
+    for (uint8_t slot = 0; slot < EEPROM_STATE_SLOTS; slot++) {
+
+        state_record_t record;
+        EEPROM.get(EEPROM_STATE_ADDRESS + (slot * sizeof(record)), record);
+
+        // slot was never written or the write was interrupted
+        if (record.crc != frame_crc((uint8_t*)&record, sizeof(record) - 1)) {
+            continue;
+        }
+
+        // newest record has the largest count, allowing for wraparound
+        if (false == is_found || 0 < (int16_t)(record.count - this->state_count)) {
+
+            is_found = true;
+            this->state_slot = slot;
+            this->state_count = record.count;
+            memcpy(this->node_status, record.node_status, sizeof(this->node_status));
         }
     }
 
-    return num_vacant;
-}
\ No newline at end of file
+    memcpy(this->persisted_status, this->node_status, sizeof(this->persisted_status));
+
+    return is_found;
+}
+#endif
+
+
+bool BaseStation::persist_state() {
+
+#if EEPROM_STATE_ENABLED
+    // nothing changed since the last write
+    if (0 == memcmp(this->persisted_status, this->node_status, sizeof(this->node_status))) {
+        return false;
+    }
+
+    // let more changes accumulate
+    if (PERSIST_INTERVAL_MS > (millis() - this->persist_ms)) {
+        return false;
+    }
+
+    state_record_t record;
+    record.count = this->state_count + 1;
+    memcpy(record.node_status, this->node_status, sizeof(record.node_status));
+    record.crc = frame_crc((uint8_t*)&record, sizeof(record) - 1);
+
+    // older records stay intact in case power is lost mid-write
+    this->state_slot = (this->state_slot + 1) % EEPROM_STATE_SLOTS;
+    EEPROM.put(EEPROM_STATE_ADDRESS + (this->state_slot * sizeof(record)), record);
+
+    this->state_count = record.count;
+    memcpy(this->persisted_status, this->node_status, sizeof(this->persisted_status));
+    this->persist_ms = millis();
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+uint8_t BaseStation::num_vacant() {
+
+    // count number of vacant statuses
+    return bitmap_count(this->node_status, SENSOR_NODE_NUM);
+}
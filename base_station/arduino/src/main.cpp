@@ -11,29 +11,258 @@
 #include <Wire.h>
 
 // local libraries
+#include <Counters.h>
 #include <Log.h>
 
 // local dependencies
 #include "basestation.hpp"
 #include "parkingdisplay.hpp"
+#include "uplink.hpp"
 
 
-// unique ID for base station
+// unique ID for base station, one of the layout's sinks
 #define BASE_STATION 0
 
+static_assert(layout_is_sink(BASE_STATION), "base station must be a sink of the layout");
+
 // baud rate for serial connection
-#define SERIAL_BAUD 9600
+#define SERIAL_BAUD 115200
 
-// delay in main loop in milliseconds
-#define MAIN_LOOP_DELAY_MS 100
+// longest wait for a message before servicing the host in milliseconds
+#define IDLE_TIMEOUT_MS 100
 
-// size of message buffer
-#define MSG_BUFFER_SIZE 32
+// most messages processed in one batch before the display and beacon are
+// serviced again (the receive queue plus the radio's 3 entry FIFO)
+#define INGEST_BURST_MAX (RX_QUEUE_SIZE + 3)
 
 
 // base station of WSN
 BaseStation base_station = BaseStation(BASE_STATION);
 
+// binary stream of the lot state to a host
+Uplink uplink = Uplink(&base_station);
+
+
+/**
+ * @brief Applies a reported status of a sensor node.
+ * 
+ * Updates the stored status, the display and the host if the vacancy
+ * status of the node changed or was confirmed for the first time.
+ * 
+ * @param node_id: ID of node reporting its status
+ * @param is_vacant: Node's vacancy status
+ * @param is_confirming: if the status is the first heard from the node since
+ *      startup or the last request
+ */
+static void handle_status_update(uint8_t node_id, bool is_vacant, bool is_confirming) {
+
+    // verify node to update has a valid ID
+    if(false == base_station.is_valid_sensor_node(node_id)) {
+        WARN("Cannot update status of invalid Node %d", node_id);
+    }
+
+    // only update if vacancy status changed or a stale status was confirmed
+    else if (is_vacant != base_station.get_node_status(node_id) || true == is_confirming) {
+
+        // update the status of the reporting node
+        (void) base_station.update_node_status(node_id, is_vacant);
+        
+        // node status is vacant
+        if (true == is_vacant) {
+            INFO("Node %d is now vacant", node_id)
+        }
+
+        // node status is occupied
+        else {
+            INFO("Node %d is now occupied", node_id)
+        }
+
+        bool is_confirmed = base_station.is_node_synced(node_id);
+
+        // update the status of the parking space
+        update_parking_space(node_id, is_vacant, is_confirmed);
+
+        // stream the change to the host, where a dropped change is
+        // corrected by the next snapshot
+        (void) uplink.send_status(node_id, is_vacant, is_confirmed);
+    }
+}
+
+
+/**
+ * @brief Handles a received UPDATE message.
+ * 
+ * @param msg: received message
+ */
+static void handle_update(MessageView* msg) {
+
+    UpdateMessage* update_msg = msg->as_update();
+
+    // message is incomplete
+    if (NULL == update_msg) {
+        WARN("Malformed UPDATE message received")
+        return;
+    }
+
+    INFO("Received UPDATE message from Node %d", update_msg->get_tx_id())
+
+    // hearing the node confirms a restored or requested status
+    bool is_confirming = (false == base_station.is_node_synced(update_msg->get_node_id()));
+
+    // ignore retransmitted and reordered statuses
+    if (false == base_station.is_new_status(update_msg->get_node_id(), update_msg->get_sequence())) {
+        INFO("Dropped duplicate status of Node %d", update_msg->get_node_id())
+        return;
+    }
+
+    base_station.share_status(update_msg->get_node_id(), update_msg->get_is_vacant(),
+        update_msg->get_sequence(), update_msg->get_tx_id());
+
+    handle_status_update(update_msg->get_node_id(), update_msg->get_is_vacant(), is_confirming);
+}
+
+
+/**
+ * @brief Handles a received AGGREGATE message.
+ * 
+ * @param msg: received message
+ */
+static void handle_aggregate(MessageView* msg) {
+
+    AggregateMessage* aggregate_msg = msg->as_aggregate();
+
+    // message is incomplete
+    if (NULL == aggregate_msg) {
+        WARN("Malformed AGGREGATE message received")
+        return;
+    }
+
+    INFO("Received AGGREGATE message from Node %d", aggregate_msg->get_tx_id())
+
+    // statuses relayed by a peer sink do not confirm the node
+    bool is_relayed = base_station.is_peer_sink(aggregate_msg->get_tx_id());
+
+    // apply every status in the message
+    for (uint8_t i = 0; i < aggregate_msg->get_num_entries(); i++) {
+
+        // hearing the node confirms a restored or requested status
+        bool is_confirming = (false == is_relayed)
+            && (false == base_station.is_node_synced(aggregate_msg->get_node_id(i)));
+
+        // ignore retransmitted and reordered statuses
+        if (false == base_station.is_new_status(aggregate_msg->get_node_id(i), aggregate_msg->get_sequence(i))) {
+            INFO("Dropped duplicate status of Node %d", aggregate_msg->get_node_id(i))
+            continue;
+        }
+
+        base_station.share_status(aggregate_msg->get_node_id(i), aggregate_msg->get_is_vacant(i),
+            aggregate_msg->get_sequence(i), aggregate_msg->get_tx_id());
+
+        handle_status_update(aggregate_msg->get_node_id(i), aggregate_msg->get_is_vacant(i), is_confirming);
+    }
+}
+
+
+/**
+ * @brief Handles a received SNAPSHOT message.
+ * 
+ * @param msg: received message
+ */
+static void handle_snapshot(MessageView* msg) {
+
+    SnapshotMessage* snapshot_msg = msg->as_snapshot();
+
+    // message is incomplete
+    if (NULL == snapshot_msg) {
+        WARN("Malformed SNAPSHOT message received")
+        return;
+    }
+
+    INFO("Received SNAPSHOT message from Node %d", snapshot_msg->get_tx_id())
+
+    // ignore retransmitted and reordered snapshots
+    if (false == base_station.is_new_snapshot(snapshot_msg->get_tx_id(), snapshot_msg->get_sequence())) {
+        INFO("Dropped stale snapshot of Node %d", snapshot_msg->get_tx_id())
+        return;
+    }
+
+    // apply the status of every node in the snapshot
+    for (uint8_t i = 0; i < snapshot_msg->get_num_nodes(); i++) {
+        uint8_t node_id = snapshot_msg->get_first_node_id() + i;
+
+        // statuses heard through this sink are newer than any a peer relays
+        if (false == snapshot_msg->has_status(node_id) || true == base_station.is_region_node(node_id)) {
+            continue;
+        }
+
+        // statuses relayed by a peer sink do not confirm the node
+        handle_status_update(node_id, snapshot_msg->get_is_vacant(node_id), false);
+    }
+}
+
+
+/**
+ * @brief Handles a received STATS message.
+ * 
+ * @param msg: received message
+ */
+static void handle_stats(MessageView* msg) {
+
+    StatsMessage* stats_msg = msg->as_stats();
+
+    // message is incomplete
+    if (NULL == stats_msg) {
+        WARN("Malformed STATS message received")
+        return;
+    }
+
+    INFO("Received STATS message of Node %d", stats_msg->get_node_id())
+
+    uint16_t values[STATS_MAX_COUNTERS];
+
+    for (uint8_t i = 0; i < stats_msg->get_num_counters(); i++) {
+        values[i] = stats_msg->get_counter(i);
+    }
+
+    // counters are only of use to the host
+    (void) uplink.send_stats(stats_msg->get_node_id(), values, stats_msg->get_num_counters());
+}
+
+
+/**
+ * @brief Handles a received TRACE message.
+ * 
+ * @param msg: received message
+ */
+static void handle_trace(MessageView* msg) {
+
+    TraceMessage* trace_msg = msg->as_trace();
+
+    // message is incomplete
+    if (NULL == trace_msg) {
+        WARN("Malformed TRACE message received")
+        return;
+    }
+
+    INFO("Received TRACE message of Node %d over %d hops", trace_msg->get_origin_id(),
+        trace_msg->get_num_hops())
+
+    // per-hop breakdown is only of use to the host
+    (void) uplink.send_trace(trace_msg);
+}
+
+
+// handlers for each type of message the base station reacts to
+static const message_handler_t message_handlers[] = {
+    {MESSAGE_UPDATE, handle_update},
+    {MESSAGE_AGGREGATE, handle_aggregate},
+    {MESSAGE_SNAPSHOT, handle_snapshot},
+    {MESSAGE_STATS, handle_stats},
+    {MESSAGE_TRACE, handle_trace}
+};
+
+#define NUM_MESSAGE_HANDLERS (sizeof(message_handlers) / sizeof(message_handlers[0]))
+
 
 /**
  * @brief Initialize all necessary objects and variables.
@@ -63,97 +292,128 @@ void setup() {
     // update screen to show the parking map
     draw_parking_map();
 
+    // show the restored state as unconfirmed until nodes confirm it
+    for (uint8_t id = 1; id <= SENSOR_NODE_NUM; id++) {
+        update_parking_space(id, base_station.get_node_status(id), base_station.is_node_synced(id));
+    }
+
     INFO("setup complete")
 }
 
 
+/**
+ * @brief Processes the oldest received message.
+ */
+static void ingest_message() {
+
+    MessageView msg = MessageView();
+
+    if (false == base_station.receive_message(&msg) || false == msg.is_valid()) {
+        ERROR("Failed to read message");
+        COUNTER_INC(COUNTER_DROPS);
+    }
+
+    // verify message is for base station
+    else if (base_station.get_id() != msg.header()->get_rx_id()) {
+        WARN("Messaged intended for Node %d not Node %d", msg.header()->get_rx_id(), base_station.get_id());
+        COUNTER_INC(COUNTER_DROPS);
+    }
+
+    // verify sender has a valid ID
+    else if(false == base_station.is_valid_sensor_node(msg.header()->get_tx_id())
+            && false == base_station.is_peer_sink(msg.header()->get_tx_id())) {
+        WARN("Message was from invalid Node %d", msg.header()->get_tx_id());
+        COUNTER_INC(COUNTER_DROPS);
+    }
+
+    // verify the sender matches the neighbor pipe it arrived on
+    else if (0 <= base_station.get_message_sender() && base_station.get_message_sender() != msg.header()->get_tx_id()) {
+        WARN("Message from Node %d arrived on pipe of Node %d", msg.header()->get_tx_id(), base_station.get_message_sender());
+        COUNTER_INC(COUNTER_DROPS);
+    }
+
+    // react accordingly based on message type
+    else if (false == dispatch_message(&msg, message_handlers, NUM_MESSAGE_HANDLERS)) {
+        WARN("Unknown message type received")
+        COUNTER_INC(COUNTER_DROPS);
+    }
+
+    base_station.release_message();
+}
+
+
 /**
  * @brief Main program run loop.
  * 
  * Continuously listens for messages from sensor nodes and updates
- * the parking space status accordingly on a display.
+ * the parking space status accordingly on a display and the host.
  */
 void loop() {
 
-    if(true == base_station.is_message()) {
+    counters_loop_begin();
 
-        uint8_t buffer[MSG_BUFFER_SIZE];
-        memset(buffer, 0, sizeof(buffer));
+    // answer host requests and send periodic snapshots
+    uplink.update();
 
-        if (false == base_station.read_message((uint8_t**)(&buffer), (uint8_t)sizeof(buffer))) {
-            ERROR("Failed to read message");
+    // start a new TDMA superframe
+    if (true == base_station.is_beacon_due()) {
+
+        if (false == base_station.transmit_beacon()) {
+            WARN("Failed to transmit beacon")
         }
+    }
 
-        else {
-            // convert buffer to Message
-            Message msg = Message();
-            memcpy(&msg, buffer, sizeof(msg));
-
-            // verify message is for base station
-            if (base_station.get_id() != msg.get_rx_id()) {
-                WARN("Messaged intended for Node " + msg.get_rx_id() + " not Node " + base_station.get_id());
-            }
-
-            // verify sender has a valid ID
-            else if(false == base_station.is_valid_sensor_node(msg.get_tx_id())) {
-                WARN("Message was from invalid Node " + msg.get_tx_id());
-            }
-
-            // react accordingly based on message type
-            else {
-
-                uint8_t type = msg.get_type();
-                switch(type) {
-
-                    case MESSAGE_UPDATE: {
-
-                        INFO("Received UPDATE message from Node " + msg.get_tx_id())
-                        
-                        // convert buffer to UpdateMessage
-                        UpdateMessage update_msg = UpdateMessage();
-                        memcpy(&update_msg, buffer, sizeof(update_msg));
-
-                        uint8_t node_id = update_msg.get_node_id();
-                        bool is_vacant = update_msg.get_is_vacant();
-
-                        // verify node to update has a valid ID
-                        if(false == base_station.is_valid_sensor_node(node_id)) {
-                            WARN("Cannot update status of invalid Node " + node_id);
-                        }
-
-                        // only update if vacancy status changed
-                        else if (is_vacant != base_station.get_node_status(node_id)) {
-
-                            // update the status of the reporting node
-                            (void) base_station.update_node_status(node_id, is_vacant);
-                            
-                            // node status is vacant
-                            if (true == is_vacant) {
-                                INFO("Node " + node_id + " is now vacant")
-                            }
-
-                            // node status is occupied
-                            else {
-                                INFO("Node " + node_id + " is now occupied")
-                            }
-
-                            // update the status of the parking space
-                            update_parking_space(node_id, is_vacant);
-                        }
-
-                        break;
-                    }
-
-                    default:
-                        WARN("Unknown message type received")
-                        break;
-                }
-            }
+    // pull statuses not yet heard since startup or requested by the host
+    if (true == base_station.is_query_due()) {
+
+        if (false == base_station.transmit_query()) {
+            WARN("Failed to transmit query")
         }
     }
 
-    // nothing to do
-    else {
-        delay(MAIN_LOOP_DELAY_MS);
+    // send a config from the host into the network
+    if (true == base_station.is_config_due()) {
+
+        if (false == base_station.transmit_config()) {
+            WARN("Failed to transmit config")
+        }
+    }
+
+    // process every message that arrived since the last wake as one batch,
+    // releasing each one pulls in any left waiting in the radio's FIFO
+    uint8_t num_ingested = 0;
+
+    while (INGEST_BURST_MAX > num_ingested && true == base_station.is_message()) {
+        ingest_message();
+        num_ingested++;
+    }
+
+    // keep the other sinks' displays showing this sink's region
+    if (true == base_station.is_share_due()) {
+
+        if (false == base_station.transmit_shares()) {
+            WARN("Failed to share statuses with peer sinks")
+        }
     }
+
+    // save the lot state once changes settle
+    (void) base_station.persist_state();
+
+    // draw every parking space the batch changed once the next frame starts
+    if (true == is_parking_display_dirty()) {
+        render_parking_display();
+    }
+
+    // nothing to do so wait for the radio to interrupt
+    else if (0 == num_ingested) {
+        // passes that only idle do not count toward the loop timing
+        counters_loop_cancel();
+
+        // write out buffered log records while there is time
+        log_drain();
+
+        (void) base_station.wait_for_message(min((uint32_t)IDLE_TIMEOUT_MS, base_station.get_time_until_beacon()));
+    }
+
+    counters_loop_end();
 }
@@ -7,19 +7,48 @@
 
 // standard libraries
 #include <Arduino.h>
+#include <avr/pgmspace.h>
 #include <TVout.h>
 
+// local libraries
+#include <Message.h>
+#include <Layout.h>
+
 
 #define SCREEN_REGION NTSC // region of the display
 #define SCREEN_W      64   // width in pixels of the display
 #define SCREEN_H      48   // height in pixels of the display
 
+// number of framebuffer bytes holding one line of pixels (1 bit per pixel)
+#define SCREEN_BYTES_PER_LINE (SCREEN_W / 8)
+
 // thickness of all lines drawn
 #define LINE_PIXEL_THICKNESS 2
 
-#define NUM_OF_CARS 10  // max number of cars that can be parked
-#define CAR_PIXEL_W 6   // width of car icon in pixels
-#define CAR_PIXEL_H 5   // height of car icon in pixels
+#define NUM_OF_CARS LAYOUT_MAX_NODE_ID  // max number of cars that can be parked
+
+// stall sizes in pixels including one of their separator lines, scaled so
+// every stall of the layout fits on the screen
+#define STALL_PIXEL_W ((SCREEN_W - LINE_PIXEL_THICKNESS) / LAYOUT_STALL_COLS)
+#define STALL_PIXEL_H ((SCREEN_H - LINE_PIXEL_THICKNESS) / LAYOUT_STALL_ROWS)
+
+// length in pixels of a stall from its back wall, leaving the rest of the
+// stall's width as aisle
+#define STALL_PIXEL_DEPTH ((STALL_PIXEL_W * 3) / 4)
+
+// car icons fill part of the stall between its lines
+#define CAR_PIXEL_W (((STALL_PIXEL_DEPTH - LINE_PIXEL_THICKNESS) * 2) / 3)    // width of car icon in pixels
+#define CAR_PIXEL_H ((STALL_PIXEL_H - LINE_PIXEL_THICKNESS + 1) / 2)        // height of car icon in pixels
+
+static_assert(0 < CAR_PIXEL_W && 0 < CAR_PIXEL_H, "too many stalls to fit on the screen");
+
+// cars of unconfirmed statuses are inset with the opposite color, leaving an
+// outline of an occupied space and a dot in a vacant one
+#define UNCONFIRMED_OCCUPIED_INSET 1    // width of the outline in pixels
+#define UNCONFIRMED_VACANT_INSET 2      // distance of the dot from the car's edges in pixels
+
+static_assert((2 * UNCONFIRMED_VACANT_INSET) < CAR_PIXEL_W && (2 * UNCONFIRMED_VACANT_INSET) < CAR_PIXEL_H,
+              "cars are too small to show unconfirmed statuses");
 
 
 // 2D coordinate
@@ -28,27 +57,142 @@ struct position_t {
     uint8_t y;
 };
 
-position_t space_locations[NUM_OF_CARS] = {
-    {4, 15},    // parking space 1
-    {4, 4},     // parking space 2
-    {21, 17},   // parking space 3
-    {21, 28},   // parking space 4
-    {21, 39},   // parking space 5
-    {33, 17},   // parking space 6
-    {33, 28},   // parking space 7
-    {33, 39},   // parking space 8
-    {50, 4},    // parking space 9
-    {50, 15}    // parking space 10
+
+/**
+ * @brief Gets the horizontal position of a column of stalls.
+ * 
+ * Stalls in even columns have their back wall on the left and stalls in odd
+ * columns on the right, so pairs of columns face each other across an aisle.
+ * 
+ * @param col: column of the stall
+ * @return Position of the left edge of the stall including its back wall
+ */
+static constexpr uint8_t get_stall_x(uint8_t col) {
+
+    if (0 == (col % 2)) {
+        return col * STALL_PIXEL_W;
+    }
+
+    return ((col + 1) * STALL_PIXEL_W) + LINE_PIXEL_THICKNESS - STALL_PIXEL_DEPTH;
+}
+
+
+/**
+ * @brief Gets the horizontal position of the back wall of a column of stalls.
+ * 
+ * @param col: column of the stall
+ * @return Position of the left edge of the back wall
+ */
+static constexpr uint8_t get_stall_wall_x(uint8_t col) {
+
+    if (0 == (col % 2)) {
+        return get_stall_x(col);
+    }
+
+    return get_stall_x(col) + STALL_PIXEL_DEPTH - LINE_PIXEL_THICKNESS;
+}
+
+
+// positions of everything drawn on the display
+struct display_layout_t {
+
+    // position of each parking space's car icon
+    position_t space_locations[NUM_OF_CARS];
+
+    // parking space of every stall or LAYOUT_NONE
+    uint8_t stalls[LAYOUT_STALL_ROWS][LAYOUT_STALL_COLS];
+
+    /**
+     * @brief Generates the display geometry from the parking lot layout
+     */
+    constexpr display_layout_t() : space_locations(), stalls() {
+
+        for (uint8_t i = 0; i < NUM_OF_CARS; i++) {
+            space_locations[i] = {LAYOUT_NONE, LAYOUT_NONE};
+        }
+
+        for (uint8_t row = 0; row < LAYOUT_STALL_ROWS; row++) {
+            for (uint8_t col = 0; col < LAYOUT_STALL_COLS; col++) {
+
+                uint8_t space_id = layout_node_at_stall(LAYOUT_CELL(row, col));
+                stalls[row][col] = space_id;
+
+                if (LAYOUT_NONE == space_id) {
+                    continue;
+                }
+
+                // inside of stall starts after the back wall in even columns
+                uint8_t inside_x = get_stall_x(col) + ((0 == (col % 2)) ? LINE_PIXEL_THICKNESS : 0);
+
+                // center car between the stall's lines
+                space_locations[space_id - 1] = {
+                    (uint8_t)(inside_x + ((STALL_PIXEL_DEPTH - LINE_PIXEL_THICKNESS - CAR_PIXEL_W) / 2)),
+                    (uint8_t)((row * STALL_PIXEL_H) + LINE_PIXEL_THICKNESS
+                              + ((STALL_PIXEL_H - LINE_PIXEL_THICKNESS - CAR_PIXEL_H) / 2))
+                };
+            }
+        }
+    }
 };
 
+static const display_layout_t display_layout PROGMEM = display_layout_t();
+
 
 // screen for displaying parking space status
 TVout screen = TVout();
 
+// parking spaces whose car needs to be drawn or erased
+uint8_t dirty_spaces[BITMAP_SIZE(NUM_OF_CARS)] = {0};
+
+// vacancy status to draw for each parking space
+uint8_t space_vacancies[BITMAP_SIZE(NUM_OF_CARS)] = {0};
+
+// parking spaces whose status was not heard from their node
+uint8_t unconfirmed_spaces[BITMAP_SIZE(NUM_OF_CARS)] = {0};
+
+// number of parking spaces waiting to be drawn
+uint8_t num_dirty_spaces = 0;
+
+// vertical blanking has started since the last render
+volatile bool is_frame_started = false;
+
+
+/**
+ * @brief Records the start of vertical blanking.
+ * 
+ * @note called by TVout from its video interrupt
+ */
+static void on_vertical_blank() {
+
+    is_frame_started = true;
+}
+
+
+/**
+ * @brief Sets or clears the bits selected by a mask in a framebuffer byte.
+ * 
+ * @param pixels: framebuffer byte to change
+ * @param mask: bits of pixels to change
+ * @param color: color of pixels which must be either BLACK or WHITE
+ */
+static inline void fill_byte(uint8_t* pixels, uint8_t mask, uint8_t color) {
+
+    if (WHITE == color) {
+        *pixels |= mask;
+    }
+
+    else {
+        *pixels &= ~mask;
+    }
+}
+
 
 /**
  * @brief Draws a black or white rectangle line by line.
  * 
+ * Writes whole framebuffer bytes, masking only the partial bytes at the left
+ * and right edges, instead of setting each pixel individually.
+ * 
  * @param color: color of rectangle which must be either BLACK or WHITE
  * @param x: horizontal position of upper left corner of rectangle on screen
  * @param y: vertical position of upper left corner of rectangle on screen
@@ -60,11 +204,39 @@ TVout screen = TVout();
  */
 static void draw_rectangle(uint8_t color, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
 
+    // nothing to draw
+    if (0 == width || 0 == height) {
+        return;
+    }
+
+    uint8_t first_byte = x / 8;
+    uint8_t last_byte = (x + width - 1) / 8;
+
+    // pixels are stored most significant bit first
+    uint8_t first_mask = 0xFF >> (x % 8);
+    uint8_t last_mask = 0xFF << (7 - ((x + width - 1) % 8));
+
+    // rectangle starts and ends in the same byte
+    if (first_byte == last_byte) {
+        first_mask &= last_mask;
+    }
+
+    uint8_t fill = (WHITE == color) ? 0xFF : 0x00;
+    uint8_t* line = screen.screen + (y * SCREEN_BYTES_PER_LINE);
+
     // draw rectangle line by line
     for (uint8_t dy = 0; dy < height; dy++) {
-        for (uint8_t dx = 0; dx < width; dx++) {
-            screen.set_pixel(x + dx, y + dy, color);
+
+        fill_byte(&line[first_byte], first_mask, color);
+
+        if (first_byte != last_byte) {
+
+            // whole bytes between the edges
+            memset(&line[first_byte + 1], fill, last_byte - first_byte - 1);
+            fill_byte(&line[last_byte], last_mask, color);
         }
+
+        line += SCREEN_BYTES_PER_LINE;
     }
 }
 
@@ -86,6 +258,19 @@ static void draw_rectangle(uint8_t color, position_t position, uint8_t width, ui
 }
 
 
+/**
+ * @brief Gets the parking space drawn in a stall of the display.
+ * 
+ * @param row: row of the stall
+ * @param col: column of the stall
+ * @return ID of the parking space. Otherwise LAYOUT_NONE
+ */
+static uint8_t get_stall_space(uint8_t row, uint8_t col) {
+
+    return pgm_read_byte(&display_layout.stalls[row][col]);
+}
+
+
 bool init_parking_display() {
 
     // intialize the screen
@@ -96,40 +281,106 @@ bool init_parking_display() {
     // clear the screen
     screen.clear_screen();
 
+    // render while the video interrupt is not drawing lines
+    screen.set_vbi_hook(on_vertical_blank);
+
     return true;
 }
 
 
 void draw_parking_map() {
 
-    // draw boarders
-    draw_rectangle(WHITE, 0, 0, LINE_PIXEL_THICKNESS, 24);  // left boarder
-    draw_rectangle(WHITE, 2, 0, 56, LINE_PIXEL_THICKNESS);  // top boarder
-    draw_rectangle(WHITE, 58, 0, LINE_PIXEL_THICKNESS, 24); // right boarder
-    draw_rectangle(WHITE, 0, 46, 60, LINE_PIXEL_THICKNESS); // bottom boarder
-
-    // draw parking space seperators
-    draw_rectangle(WHITE, 2, 11, 8, LINE_PIXEL_THICKNESS);      // top left
-    draw_rectangle(WHITE, 2, 22, 8, LINE_PIXEL_THICKNESS);      // bottom left
-    draw_rectangle(WHITE, 50, 11, 8, LINE_PIXEL_THICKNESS);     // top right
-    draw_rectangle(WHITE, 50, 22, 8, LINE_PIXEL_THICKNESS);     // bottom left
-    draw_rectangle(WHITE, 21, 13, 18, LINE_PIXEL_THICKNESS);    // top middle
-    draw_rectangle(WHITE, 21, 24, 18, LINE_PIXEL_THICKNESS);    // middle middle
-    draw_rectangle(WHITE, 21, 35, 18, LINE_PIXEL_THICKNESS);    // bottom middle
-    draw_rectangle(WHITE, 29, 15, LINE_PIXEL_THICKNESS, 31);    // middle vertical divider
+    uint8_t lot_w = (LAYOUT_STALL_COLS * STALL_PIXEL_W) + LINE_PIXEL_THICKNESS;
+
+    // draw top and bottom boarders
+    draw_rectangle(WHITE, 0, 0, lot_w, LINE_PIXEL_THICKNESS);
+    draw_rectangle(WHITE, 0, LAYOUT_STALL_ROWS * STALL_PIXEL_H, lot_w, LINE_PIXEL_THICKNESS);
+
+    for (uint8_t row = 0; row < LAYOUT_STALL_ROWS; row++) {
+        for (uint8_t col = 0; col < LAYOUT_STALL_COLS; col++) {
+
+            // nothing to draw for empty stalls
+            if (LAYOUT_NONE == get_stall_space(row, col)) {
+                continue;
+            }
+
+            uint8_t x = get_stall_x(col);
+            uint8_t y = row * STALL_PIXEL_H;
+
+            // draw parking space seperators above and below
+            draw_rectangle(WHITE, x, y, STALL_PIXEL_DEPTH, LINE_PIXEL_THICKNESS);
+            draw_rectangle(WHITE, x, y + STALL_PIXEL_H, STALL_PIXEL_DEPTH, LINE_PIXEL_THICKNESS);
+
+            // draw back wall, which forms the boarder or divider
+            draw_rectangle(WHITE, get_stall_wall_x(col), y, LINE_PIXEL_THICKNESS, STALL_PIXEL_H + LINE_PIXEL_THICKNESS);
+        }
+    }
 }
 
 
-void update_parking_space(uint8_t space_id, bool is_vacant) {
+void update_parking_space(uint8_t space_id, bool is_vacant, bool is_confirmed) {
 
     // check to ensure space ID is valid
-    if ((0 == space_id) || ((space_id - 1) > NUM_OF_CARS)) {
+    if ((0 == space_id) || (space_id > NUM_OF_CARS)
+        || LAYOUT_NONE == pgm_read_byte(&display_layout.space_locations[space_id - 1].x)) {
+
         return;
     }
 
-    // determine if car should be drawn or erased
-    uint8_t color = (true == is_vacant) ? BLACK : WHITE;
+    uint8_t index = space_id - 1;
+
+    bitmap_set(space_vacancies, index, is_vacant);
+    bitmap_set(unconfirmed_spaces, index, false == is_confirmed);
+
+    // repeated updates to a space are drawn once
+    if (false == bitmap_get(dirty_spaces, index)) {
+        bitmap_set(dirty_spaces, index, true);
+        num_dirty_spaces++;
+    }
+}
 
-    // draw or erase car
-    draw_rectangle(color, space_locations[space_id - 1], CAR_PIXEL_W, CAR_PIXEL_H);
+
+bool is_parking_display_dirty() {
+
+    return 0 < num_dirty_spaces;
+}
+
+
+void render_parking_display() {
+
+    // draw at most once per frame
+    if (false == is_frame_started) {
+        return;
+    }
+
+    is_frame_started = false;
+
+    for (uint8_t i = 0; i < NUM_OF_CARS && 0 < num_dirty_spaces; i++) {
+
+        if (false == bitmap_get(dirty_spaces, i)) {
+            continue;
+        }
+
+        // determine if car should be drawn or erased
+        bool is_vacant = bitmap_get(space_vacancies, i);
+        uint8_t color = (true == is_vacant) ? BLACK : WHITE;
+
+        // draw or erase car
+        position_t location;
+        memcpy_P(&location, &display_layout.space_locations[i], sizeof(location));
+
+        draw_rectangle(color, location, CAR_PIXEL_W, CAR_PIXEL_H);
+
+        // mark a status not heard from its node as stale
+        if (true == bitmap_get(unconfirmed_spaces, i)) {
+
+            uint8_t inset = (true == is_vacant) ? UNCONFIRMED_VACANT_INSET : UNCONFIRMED_OCCUPIED_INSET;
+
+            draw_rectangle((true == is_vacant) ? WHITE : BLACK, location.x + inset, location.y + inset,
+                           CAR_PIXEL_W - (2 * inset), CAR_PIXEL_H - (2 * inset));
+        }
+
+        bitmap_set(dirty_spaces, i, false);
+        num_dirty_spaces--;
+    }
 }
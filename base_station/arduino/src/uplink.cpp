@@ -0,0 +1,221 @@
+/**
+* @brief: Contains the implementation of the Uplink class.
+* @file: uplink.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local libraries
+#include <Counters.h>
+#include <Message.h>
+
+// local dependencies
+#include "uplink.hpp"
+#include "basestation.hpp"
+
+
+// time between snapshots sent without being requested in milliseconds
+#define UPLINK_SNAPSHOT_INTERVAL_MS 5000
+
+// time between stats of the base station in milliseconds
+#define UPLINK_STATS_INTERVAL_MS 60000
+
+
+Uplink::Uplink(BaseStation* base_station) {
+
+    this->base_station = base_station;
+}
+
+
+bool Uplink::send_frame(uint8_t type, const uint8_t* payload, uint8_t size) {
+
+#if UPLINK_ENABLED
+    uint8_t frame[UPLINK_MAX_FRAME_SIZE];
+    uint8_t encoded[UPLINK_MAX_ENCODED_SIZE];
+
+    // frame does not fit
+    if ((UPLINK_MAX_FRAME_SIZE - 3) < size) {
+        return false;
+    }
+
+    frame[0] = type;
+    frame[1] = this->sequence;
+    memcpy(&frame[2], payload, size);
+    frame[2 + size] = frame_crc(frame, 2 + size);
+
+    // delimiters on both sides keep any text logged in between separate
+    encoded[0] = COBS_DELIMITER;
+    uint8_t encoded_size = 1 + cobs_encode(frame, 3 + size, &encoded[1]);
+    encoded[encoded_size++] = COBS_DELIMITER;
+
+    // never wait for the serial buffer to drain
+    if (encoded_size > Serial.availableForWrite()) {
+        this->num_dropped++;
+        return false;
+    }
+
+    (void) Serial.write(encoded, encoded_size);
+    this->sequence++;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+bool Uplink::send_status(uint8_t node_id, bool is_vacant, bool is_confirmed) {
+
+    uint8_t payload[3] = {node_id, (uint8_t)is_vacant, (uint8_t)is_confirmed};
+
+    return this->send_frame(UPLINK_STATUS, payload, sizeof(payload));
+}
+
+
+bool Uplink::send_snapshot() {
+
+    uint8_t payload[1 + (2 * BITMAP_SIZE(SENSOR_NODE_NUM))] = {0};
+    payload[0] = SENSOR_NODE_NUM;
+
+    uint8_t* vacancies = &payload[1];
+    uint8_t* unconfirmed = &payload[1 + BITMAP_SIZE(SENSOR_NODE_NUM)];
+
+    // bit i of each bitmap is for node i + 1
+    for (uint8_t i = 0; i < SENSOR_NODE_NUM; i++) {
+        bitmap_set(vacancies, i, this->base_station->get_node_status(i + 1));
+        bitmap_set(unconfirmed, i, false == this->base_station->is_node_synced(i + 1));
+    }
+
+    this->snapshot_ms = millis();
+
+    return this->send_frame(UPLINK_SNAPSHOT, payload, sizeof(payload));
+}
+
+
+bool Uplink::send_stats(uint8_t node_id, const uint16_t* counters, uint8_t num_counters) {
+
+    uint8_t payload[2 + (2 * STATS_MAX_COUNTERS)];
+    num_counters = min(num_counters, (uint8_t)STATS_MAX_COUNTERS);
+
+    payload[0] = node_id;
+    payload[1] = num_counters;
+
+    for (uint8_t i = 0; i < num_counters; i++) {
+        payload[2 + (2 * i)] = counters[i] & 0xFF;
+        payload[3 + (2 * i)] = counters[i] >> 8;
+    }
+
+    return this->send_frame(UPLINK_STATS, payload, 2 + (2 * num_counters));
+}
+
+
+bool Uplink::send_trace(TraceMessage* msg) {
+
+    uint8_t payload[3 + (3 * TRACE_MAX_HOPS)];
+    uint8_t num_hops = msg->get_num_hops();
+
+    payload[0] = msg->get_origin_id();
+    payload[1] = msg->get_sequence();
+    payload[2] = num_hops;
+
+    for (uint8_t i = 0; i < num_hops; i++) {
+
+        uint16_t delay_ms = msg->get_hop_delay_ms(i);
+
+        payload[3 + (3 * i)] = msg->get_hop_node_id(i);
+        payload[4 + (3 * i)] = delay_ms & 0xFF;
+        payload[5 + (3 * i)] = delay_ms >> 8;
+    }
+
+    return this->send_frame(UPLINK_TRACE, payload, 3 + (3 * num_hops));
+}
+
+
+void Uplink::handle_frame(uint8_t* frame, uint8_t size) {
+
+    size = cobs_decode(frame, size);
+
+    // frame must hold at least a type, sequence number and CRC
+    if (3 > size || frame[size - 1] != frame_crc(frame, size - 1)) {
+        return;
+    }
+
+    // host requested the state of the lot
+    if (UPLINK_DUMP == frame[0]) {
+        (void) this->send_snapshot();
+    }
+
+    // host requested fresh statuses from the sensor nodes
+    else if (UPLINK_QUERY == frame[0] && 4 == size) {
+
+        // node ID 0 asks for every node
+        for (uint8_t id = 1; id <= SENSOR_NODE_NUM; id++) {
+
+            if (0 == frame[2] || id == frame[2]) {
+                (void) this->base_station->request_status(id);
+            }
+        }
+    }
+
+    // host pushed a new config for one or every node
+    else if (UPLINK_CONFIG == frame[0] && UPLINK_CONFIG_FRAME_SIZE == size) {
+
+        config_settings_t settings;
+        memcpy(&settings, &frame[4], sizeof(settings));
+
+        uint8_t base_id = this->base_station->get_id();
+        ConfigMessage msg = ConfigMessage(base_id, base_id, frame[2], frame[3], settings);
+
+        this->base_station->queue_config(&msg);
+    }
+}
+
+
+void Uplink::update() {
+
+#if UPLINK_ENABLED
+    // collect bytes from the host until a frame is complete
+    while (0 < Serial.available()) {
+
+        uint8_t data = Serial.read();
+
+        if (COBS_DELIMITER == data) {
+
+            if (0 < this->rx_size) {
+                this->handle_frame(this->rx_frame, this->rx_size);
+            }
+
+            this->rx_size = 0;
+        }
+
+        // discard frames too large to be a request
+        else if (sizeof(this->rx_frame) > this->rx_size) {
+            this->rx_frame[this->rx_size++] = data;
+        }
+    }
+
+    // periodically resend everything in case a status change was dropped
+    if (UPLINK_SNAPSHOT_INTERVAL_MS <= (millis() - this->snapshot_ms)) {
+        (void) this->send_snapshot();
+    }
+
+    // counters of the base station itself
+    if (UPLINK_STATS_INTERVAL_MS <= (millis() - this->stats_ms)) {
+
+        uint16_t values[NUM_COUNTERS];
+        counters_snapshot(values);
+
+        (void) this->send_stats(this->base_station->get_id(), values, NUM_COUNTERS);
+        this->stats_ms = millis();
+    }
+#endif
+}
+
+
+uint16_t Uplink::get_num_dropped() {
+
+    return this->num_dropped;
+}
@@ -0,0 +1,84 @@
+/**
+* @brief: Contains the implementation of the counters
+* @file: Counters.cpp
+*
+* @author: jkieltyka15
+*/
+
+#include <Arduino.h>
+
+#include "Counters.h"
+
+
+#if COUNTERS_ENABLED
+
+uint16_t counter_values[NUM_COUNTERS] = {0, 0, 0, 0, 0, 0, 0, 0, UINT16_MAX, 0, 0};
+
+// time the current main loop pass started in microseconds
+static uint32_t loop_start_us = 0;
+static bool is_loop_started = false;
+
+
+void counters_loop_begin() {
+
+    loop_start_us = micros();
+    is_loop_started = true;
+}
+
+
+void counters_loop_end() {
+
+    // pass was cancelled
+    if (false == is_loop_started) {
+        return;
+    }
+
+    is_loop_started = false;
+
+    uint32_t elapsed_us = micros() - loop_start_us;
+    uint16_t duration_us = (UINT16_MAX < elapsed_us) ? UINT16_MAX : (uint16_t)elapsed_us;
+
+    if (duration_us < counter_values[COUNTER_LOOP_MIN_US]) {
+        counter_values[COUNTER_LOOP_MIN_US] = duration_us;
+    }
+
+    if (duration_us > counter_values[COUNTER_LOOP_MAX_US]) {
+        counter_values[COUNTER_LOOP_MAX_US] = duration_us;
+    }
+}
+
+
+void counters_loop_cancel() {
+
+    is_loop_started = false;
+}
+
+
+void counters_snapshot(uint16_t* values) {
+
+    // receive counters are updated by the radio's interrupt
+    noInterrupts();
+    memcpy(values, counter_values, sizeof(counter_values));
+    interrupts();
+
+    counter_values[COUNTER_LOOP_MIN_US] = UINT16_MAX;
+    counter_values[COUNTER_LOOP_MAX_US] = 0;
+}
+
+#else
+
+void counters_loop_begin() {}
+
+
+void counters_loop_end() {}
+
+
+void counters_loop_cancel() {}
+
+
+void counters_snapshot(uint16_t* values) {
+
+    memset(values, 0, NUM_COUNTERS * sizeof(uint16_t));
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**
+* @brief: Contains the counters of what a node spends its time on
+* @file: Counters.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _COUNTERS_H_
+#define _COUNTERS_H_
+
+#include <Arduino.h>
+
+// count radio and main loop activity for stats messages (0 to disable). Can
+// be set with -D in build_flags.
+#ifndef COUNTERS_ENABLED
+#define COUNTERS_ENABLED 1
+#endif
+
+// Counters are 16 bits and wrap, so a host should difference consecutive
+// reports. The loop timing counters instead cover the time since the last
+// snapshot and saturate.
+
+#define COUNTER_TX_ATTEMPTS 0   // messages handed to the radio to send
+#define COUNTER_TX_FAILURES 1   // messages the radio gave up sending
+#define COUNTER_CARRIER_BUSY 2  // carrier checks that found the channel busy
+#define COUNTER_BACKOFF_MS 3    // time spent waiting for busy channels in milliseconds
+#define COUNTER_RX_FRAMES 4     // frames read from the radio
+#define COUNTER_FORWARDS 5      // messages forwarded for other nodes
+#define COUNTER_DROPS 6         // messages or statuses given up
+#define COUNTER_RX_OVERFLOWS 7  // times the receive queue filled with frames still waiting
+#define COUNTER_LOOP_MIN_US 8   // shortest main loop pass that did work in microseconds
+#define COUNTER_LOOP_MAX_US 9   // longest main loop pass that did work in microseconds
+#define COUNTER_RETRIES 10      // automatic retransmissions needed by delivered messages
+
+#define NUM_COUNTERS 11
+
+#if COUNTERS_ENABLED
+
+// current value of every counter
+extern uint16_t counter_values[NUM_COUNTERS];
+
+/**
+ * @brief Adds to a counter
+ * 
+ * @param counter: counter to add to
+ * @param amount: amount to add
+ */
+inline void counter_add(uint8_t counter, uint16_t amount) {
+
+    counter_values[counter] += amount;
+}
+
+#define COUNTER_ADD(counter, amount) counter_add(counter, amount)
+#define COUNTER_INC(counter) counter_add(counter, 1)
+
+#else
+
+#define COUNTER_ADD(counter, amount)
+#define COUNTER_INC(counter)
+
+#endif
+
+/**
+ * @brief Marks the start of a main loop pass
+ */
+void counters_loop_begin();
+
+/**
+ * @brief Marks the end of a main loop pass and records its duration
+ */
+void counters_loop_end();
+
+/**
+ * @brief Discards the current main loop pass from the loop timing
+ * 
+ * Call for passes that only idle so waiting is not counted.
+ */
+void counters_loop_cancel();
+
+/**
+ * @brief Copies every counter and restarts the loop timing
+ * 
+ * @param values: buffer of NUM_COUNTERS values to copy to
+ */
+void counters_snapshot(uint16_t* values);
+
+#endif // _COUNTERS_H_
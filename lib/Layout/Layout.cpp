@@ -0,0 +1,14 @@
+/**
+* @brief: Contains the layout table generated from the layout descriptor
+* @file: Layout.cpp
+*
+* @author: jkieltyka15
+*/
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+#include "Layout.h"
+
+
+const layout_table_t layout_table PROGMEM = layout_table_t();
@@ -0,0 +1,447 @@
+/**
+* @brief: Contains the descriptor of the parking lot layout
+* @file: Layout.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _LAYOUT_H_
+#define _LAYOUT_H_
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// The routing table, display geometry and node status storage are all
+// generated at compile time from layout_nodes, so only the generated tables
+// are stored on the devices. layout_nodes lives in flash, so the constexpr
+// helpers below are only for compile time and code running on the devices
+// reads layout_table with the layout_read functions instead.
+//
+// Nodes without a parking stall are sinks, base stations that collect the
+// statuses of the nodes around them. Each sensor node routes toward the
+// nearest sink on the routing grid and sinks share what they collect, so a
+// large lot can be split between several sinks.
+
+#define LAYOUT_GRID_ROWS 4  // rows of the grid nodes are placed on for routing
+#define LAYOUT_GRID_COLS 4  // columns of the grid nodes are placed on for routing
+
+#define LAYOUT_STALL_ROWS 4 // rows of parking stalls drawn on the display
+#define LAYOUT_STALL_COLS 4 // columns of parking stalls drawn on the display
+
+#define LAYOUT_BASE_STATION_ID 0    // ID of the base station, which is always a sink
+#define LAYOUT_MAX_ID 0x7F          // largest node ID supported by the message formats
+
+#define LAYOUT_NONE 0xFF    // represents a missing node or cell
+
+#define LAYOUT_NUM_NEIGHBORS 4  // number of cells next to a cell of the routing grid
+
+// packs a row and column (0-14 each) into a single byte
+#define LAYOUT_CELL(row, col) ((uint8_t)(((row) << 4) | (col)))
+
+#define LAYOUT_ROW(cell) ((cell) >> 4)      // row of a packed cell
+#define LAYOUT_COL(cell) ((cell) & 0x0F)    // column of a packed cell
+
+
+// placement of a single node in the parking lot
+struct layout_node_t {
+    uint8_t node_id;    // ID of the node
+    uint8_t grid_cell;  // cell on the routing grid
+    uint8_t stall_cell; // cell of the parking stall on the display or LAYOUT_NONE for sinks
+};
+
+
+static constexpr layout_node_t layout_nodes[] PROGMEM = {
+    {LAYOUT_BASE_STATION_ID, LAYOUT_CELL(0, 1), LAYOUT_NONE},
+    {1, LAYOUT_CELL(0, 2), LAYOUT_CELL(1, 0)},
+    {2, LAYOUT_CELL(0, 3), LAYOUT_CELL(0, 0)},
+    {3, LAYOUT_CELL(1, 2), LAYOUT_CELL(1, 1)},
+    {4, LAYOUT_CELL(1, 1), LAYOUT_CELL(2, 1)},
+    {5, LAYOUT_CELL(1, 0), LAYOUT_CELL(3, 1)},
+    {6, LAYOUT_CELL(2, 2), LAYOUT_CELL(1, 2)},
+    {7, LAYOUT_CELL(2, 1), LAYOUT_CELL(2, 2)},
+    {8, LAYOUT_CELL(2, 0), LAYOUT_CELL(3, 2)},
+    {9, LAYOUT_CELL(3, 3), LAYOUT_CELL(0, 3)},
+    {10, LAYOUT_CELL(3, 2), LAYOUT_CELL(1, 3)}
+};
+
+// number of nodes in the parking lot including the base station
+#define LAYOUT_NUM_NODES (sizeof(layout_nodes) / sizeof(layout_nodes[0]))
+
+
+/**
+ * @brief Finds the largest node ID in the layout
+ * 
+ * @return Largest node ID
+ */
+static constexpr uint8_t layout_max_node_id() {
+
+    uint8_t max_id = 0;
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (max_id < layout_nodes[i].node_id) {
+            max_id = layout_nodes[i].node_id;
+        }
+    }
+
+    return max_id;
+}
+
+// largest node ID in the layout
+#define LAYOUT_MAX_NODE_ID layout_max_node_id()
+
+
+/**
+ * @brief Gets the node on a cell of the routing grid
+ * 
+ * @param cell: packed cell of the routing grid
+ * @return ID of the node on the cell. Otherwise LAYOUT_NONE
+ */
+static constexpr uint8_t layout_node_at_grid(uint8_t cell) {
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (cell == layout_nodes[i].grid_cell) {
+            return layout_nodes[i].node_id;
+        }
+    }
+
+    return LAYOUT_NONE;
+}
+
+
+/**
+ * @brief Gets the node whose parking stall is on a cell of the display
+ * 
+ * @param cell: packed cell of the display
+ * @return ID of the node with the stall. Otherwise LAYOUT_NONE
+ */
+static constexpr uint8_t layout_node_at_stall(uint8_t cell) {
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (cell == layout_nodes[i].stall_cell) {
+            return layout_nodes[i].node_id;
+        }
+    }
+
+    return LAYOUT_NONE;
+}
+
+
+/**
+ * @brief Gets the cell of a node on the routing grid
+ * 
+ * @param node_id: ID of the node
+ * @return Packed cell of the node. Otherwise LAYOUT_NONE
+ */
+static constexpr uint8_t layout_grid_cell(uint8_t node_id) {
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (node_id == layout_nodes[i].node_id) {
+            return layout_nodes[i].grid_cell;
+        }
+    }
+
+    return LAYOUT_NONE;
+}
+
+
+/**
+ * @brief Gets a node next to another on the routing grid
+ * 
+ * Neighbors are indexed left, right, below then above.
+ * 
+ * @param node_id: ID of the node
+ * @param index: index of the neighbor (0 to LAYOUT_NUM_NEIGHBORS - 1)
+ * @return ID of the neighboring node. Otherwise LAYOUT_NONE
+ */
+static constexpr uint8_t layout_neighbor(uint8_t node_id, uint8_t index) {
+
+    const int8_t row_offsets[LAYOUT_NUM_NEIGHBORS] = {0, 0, 1, -1};
+    const int8_t col_offsets[LAYOUT_NUM_NEIGHBORS] = {-1, 1, 0, 0};
+
+    uint8_t cell = layout_grid_cell(node_id);
+
+    if (LAYOUT_NONE == cell || LAYOUT_NUM_NEIGHBORS <= index) {
+        return LAYOUT_NONE;
+    }
+
+    int16_t row = LAYOUT_ROW(cell) + row_offsets[index];
+    int16_t col = LAYOUT_COL(cell) + col_offsets[index];
+
+    // neighbor is off the routing grid
+    if (0 > row || LAYOUT_GRID_ROWS <= row || 0 > col || LAYOUT_GRID_COLS <= col) {
+        return LAYOUT_NONE;
+    }
+
+    return layout_node_at_grid(LAYOUT_CELL(row, col));
+}
+
+
+/**
+ * @brief Gets the index of a node among the neighbors of another
+ * 
+ * @param node_id: ID of the node
+ * @param neighbor_id: ID of the possible neighbor
+ * @return Index of the neighbor (0 to LAYOUT_NUM_NEIGHBORS - 1). Otherwise LAYOUT_NONE
+ */
+static constexpr uint8_t layout_neighbor_index(uint8_t node_id, uint8_t neighbor_id) {
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NEIGHBORS; i++) {
+
+        if (neighbor_id == layout_neighbor(node_id, i)) {
+            return i;
+        }
+    }
+
+    return LAYOUT_NONE;
+}
+
+
+/**
+ * @brief Determines if a node is a sink
+ * 
+ * @param node_id: ID of the node
+ * @return True if the node is in the layout without a parking stall. Otherwise false
+ */
+static constexpr bool layout_is_sink(uint8_t node_id) {
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (node_id == layout_nodes[i].node_id) {
+            return LAYOUT_NONE == layout_nodes[i].stall_cell;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Counts the sinks in the layout
+ * 
+ * @return Number of sinks
+ */
+static constexpr uint8_t layout_num_sinks() {
+
+    uint8_t num_sinks = 0;
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (LAYOUT_NONE == layout_nodes[i].stall_cell) {
+            num_sinks++;
+        }
+    }
+
+    return num_sinks;
+}
+
+
+/**
+ * @brief Gets the sink nearest to a cell of the routing grid
+ * 
+ * Distance is counted in rows plus columns, ties go to the sink listed first.
+ * 
+ * @param cell: packed cell of the routing grid
+ * @return ID of the nearest sink
+ */
+static constexpr uint8_t layout_nearest_sink(uint8_t cell) {
+
+    uint8_t sink_id = LAYOUT_BASE_STATION_ID;
+    int16_t min_distance = INT16_MAX;
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        if (LAYOUT_NONE != layout_nodes[i].stall_cell) {
+            continue;
+        }
+
+        int16_t row_distance = LAYOUT_ROW(layout_nodes[i].grid_cell) - LAYOUT_ROW(cell);
+        int16_t col_distance = LAYOUT_COL(layout_nodes[i].grid_cell) - LAYOUT_COL(cell);
+        int16_t distance = ((0 > row_distance) ? -row_distance : row_distance)
+                         + ((0 > col_distance) ? -col_distance : col_distance);
+
+        if (min_distance > distance) {
+            min_distance = distance;
+            sink_id = layout_nodes[i].node_id;
+        }
+    }
+
+    return sink_id;
+}
+
+
+/**
+ * @brief Determines if the layout descriptor is consistent
+ * 
+ * @return True if every node has a unique ID and unique cells within the
+ *      grid and display bounds. Otherwise false
+ */
+static constexpr bool layout_is_valid() {
+
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        const layout_node_t& node = layout_nodes[i];
+
+        if (LAYOUT_MAX_ID < node.node_id
+            || LAYOUT_GRID_ROWS <= LAYOUT_ROW(node.grid_cell)
+            || LAYOUT_GRID_COLS <= LAYOUT_COL(node.grid_cell)) {
+
+            return false;
+        }
+
+        // sinks have no parking stall to check
+        if (LAYOUT_NONE != node.stall_cell
+            && (LAYOUT_STALL_ROWS <= LAYOUT_ROW(node.stall_cell)
+                || LAYOUT_STALL_COLS <= LAYOUT_COL(node.stall_cell))) {
+
+            return false;
+        }
+
+        for (uint8_t j = i + 1; j < LAYOUT_NUM_NODES; j++) {
+
+            if (node.node_id == layout_nodes[j].node_id
+                || node.grid_cell == layout_nodes[j].grid_cell
+                || (LAYOUT_NONE != node.stall_cell && node.stall_cell == layout_nodes[j].stall_cell)) {
+
+                return false;
+            }
+        }
+    }
+
+    return LAYOUT_NONE != layout_grid_cell(LAYOUT_BASE_STATION_ID) && layout_is_sink(LAYOUT_BASE_STATION_ID);
+}
+
+static_assert(layout_is_valid(), "parking lot layout is inconsistent");
+
+// limited to 15 so no packed cell can equal LAYOUT_NONE
+static_assert(15 >= LAYOUT_GRID_ROWS && 15 >= LAYOUT_GRID_COLS, "routing grid must fit in packed cells");
+static_assert(15 >= LAYOUT_STALL_ROWS && 15 >= LAYOUT_STALL_COLS, "display must fit in packed cells");
+
+
+// placement of every node ID generated from the layout for lookups at runtime
+struct layout_table_t {
+
+    uint8_t grid_cells[LAYOUT_MAX_NODE_ID + 1];    // cell on the routing grid or LAYOUT_NONE if not in the layout
+    uint8_t stall_cells[LAYOUT_MAX_NODE_ID + 1];   // cell of the parking stall or LAYOUT_NONE for sinks
+
+    // nodes next to each node on the routing grid, indexed as layout_neighbor
+    uint8_t neighbors[LAYOUT_MAX_NODE_ID + 1][LAYOUT_NUM_NEIGHBORS];
+
+    // index of every node among the neighbors of each node or LAYOUT_NONE,
+    // so the reading pipe a neighbor sends to is found without a search
+    uint8_t neighbor_indices[LAYOUT_MAX_NODE_ID + 1][LAYOUT_MAX_NODE_ID + 1];
+
+    /**
+     * @brief Generates the table from the layout descriptor
+     */
+    constexpr layout_table_t() : grid_cells(), stall_cells(), neighbors(), neighbor_indices() {
+
+        for (uint8_t id = 0; id <= LAYOUT_MAX_NODE_ID; id++) {
+
+            grid_cells[id] = LAYOUT_NONE;
+            stall_cells[id] = LAYOUT_NONE;
+
+            for (uint8_t i = 0; i < LAYOUT_NUM_NEIGHBORS; i++) {
+                neighbors[id][i] = LAYOUT_NONE;
+            }
+
+            for (uint8_t other_id = 0; other_id <= LAYOUT_MAX_NODE_ID; other_id++) {
+                neighbor_indices[id][other_id] = LAYOUT_NONE;
+            }
+        }
+
+        for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+            uint8_t id = layout_nodes[i].node_id;
+
+            grid_cells[id] = layout_nodes[i].grid_cell;
+            stall_cells[id] = layout_nodes[i].stall_cell;
+
+            for (uint8_t j = 0; j < LAYOUT_NUM_NEIGHBORS; j++) {
+
+                uint8_t neighbor_id = layout_neighbor(id, j);
+                neighbors[id][j] = neighbor_id;
+
+                if (LAYOUT_NONE != neighbor_id) {
+                    neighbor_indices[id][neighbor_id] = j;
+                }
+            }
+        }
+    }
+};
+
+// generated placement of every node ID, defined once in Layout.cpp
+extern const layout_table_t layout_table PROGMEM;
+
+
+/**
+ * @brief Reads the cell of a node on the routing grid from the layout table
+ * 
+ * @param node_id: ID of the node
+ * @return Packed cell of the node. Otherwise LAYOUT_NONE
+ */
+inline uint8_t layout_read_grid_cell(uint8_t node_id) {
+
+    if (LAYOUT_MAX_NODE_ID < node_id) {
+        return LAYOUT_NONE;
+    }
+
+    return pgm_read_byte(&layout_table.grid_cells[node_id]);
+}
+
+
+/**
+ * @brief Reads if a node is a sink from the layout table
+ * 
+ * @param node_id: ID of the node
+ * @return True if the node is in the layout without a parking stall. Otherwise false
+ */
+inline bool layout_read_is_sink(uint8_t node_id) {
+
+    if (LAYOUT_MAX_NODE_ID < node_id) {
+        return false;
+    }
+
+    return LAYOUT_NONE != pgm_read_byte(&layout_table.grid_cells[node_id])
+        && LAYOUT_NONE == pgm_read_byte(&layout_table.stall_cells[node_id]);
+}
+
+
+/**
+ * @brief Reads a node next to another on the routing grid from the layout table
+ * 
+ * @param node_id: ID of the node
+ * @param index: index of the neighbor (0 to LAYOUT_NUM_NEIGHBORS - 1)
+ * @return ID of the neighboring node. Otherwise LAYOUT_NONE
+ */
+inline uint8_t layout_read_neighbor(uint8_t node_id, uint8_t index) {
+
+    if (LAYOUT_MAX_NODE_ID < node_id || LAYOUT_NUM_NEIGHBORS <= index) {
+        return LAYOUT_NONE;
+    }
+
+    return pgm_read_byte(&layout_table.neighbors[node_id][index]);
+}
+
+
+/**
+ * @brief Reads the index of a node among the neighbors of another from the layout table
+ * 
+ * @param node_id: ID of the node
+ * @param neighbor_id: ID of the possible neighbor
+ * @return Index of the neighbor (0 to LAYOUT_NUM_NEIGHBORS - 1). Otherwise LAYOUT_NONE
+ */
+inline uint8_t layout_read_neighbor_index(uint8_t node_id, uint8_t neighbor_id) {
+
+    if (LAYOUT_MAX_NODE_ID < node_id || LAYOUT_MAX_NODE_ID < neighbor_id) {
+        return LAYOUT_NONE;
+    }
+
+    return pgm_read_byte(&layout_table.neighbor_indices[node_id][neighbor_id]);
+}
+
+
+#endif // _LAYOUT_H_
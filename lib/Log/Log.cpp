@@ -0,0 +1,176 @@
+/**
+* @brief: Contains the implementation of the logging functions
+* @file: Log.cpp
+*
+* @author: jkieltyka15
+*/
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <cobs.hpp>
+
+#include "Log.h"
+
+
+// bytes of a binary record in the ring buffer before its arguments
+// (level, format string address and number of arguments)
+#define LOG_RECORD_HEADER_SIZE 4
+
+// largest binary frame before encoding (type, sequence, format string
+// address, arguments and CRC)
+#define LOG_MAX_FRAME_SIZE (5 + (2 * LOG_MAX_ARGS))
+
+
+#if LOG_BINARY_ENABLED
+
+// number of binary records that did not fit in the ring buffer
+static uint16_t num_dropped = 0;
+
+// ring buffer of binary records waiting to be written
+static uint8_t ring[LOG_RING_SIZE];
+static uint8_t ring_head = 0;   // index of next byte to be written
+static uint8_t ring_tail = 0;   // index of next byte to be read
+
+// sequence number of the next binary frame
+static uint8_t sequence = 0;
+
+
+/**
+ * @brief Gets the number of bytes in the ring buffer
+ * 
+ * @return Number of bytes
+ */
+static uint8_t ring_count() {
+
+    return (ring_head + LOG_RING_SIZE - ring_tail) % LOG_RING_SIZE;
+}
+
+
+/**
+ * @brief Adds a byte to the ring buffer
+ * 
+ * @param data: byte to add
+ */
+static void ring_push(uint8_t data) {
+
+    ring[ring_head] = data;
+    ring_head = (ring_head + 1) % LOG_RING_SIZE;
+}
+
+
+/**
+ * @brief Gets a byte of the ring buffer without removing it
+ * 
+ * @param offset: bytes past the oldest byte
+ * @return Byte at the offset
+ */
+static uint8_t ring_peek(uint8_t offset) {
+
+    return ring[(ring_tail + offset) % LOG_RING_SIZE];
+}
+
+
+void log_record(uint8_t level, const char* fmt, const uint16_t* args, uint8_t num_args) {
+
+    uint8_t size = LOG_RECORD_HEADER_SIZE + (2 * num_args);
+
+    // one byte is always left free to tell a full buffer from an empty one
+    if ((LOG_RING_SIZE - 1 - ring_count()) < size) {
+        num_dropped++;
+        return;
+    }
+
+    uint16_t address = (uint16_t)(uintptr_t)fmt;
+
+    ring_push(level);
+    ring_push(address & 0xFF);
+    ring_push(address >> 8);
+    ring_push(num_args);
+
+    for (uint8_t i = 0; i < num_args; i++) {
+        ring_push(args[i] & 0xFF);
+        ring_push(args[i] >> 8);
+    }
+
+    // errors usually precede a hang so send them right away
+    if (LOG_LEVEL_ERROR == level) {
+        log_drain();
+    }
+}
+
+
+void log_drain() {
+
+    uint8_t frame[LOG_MAX_FRAME_SIZE];
+    uint8_t encoded[COBS_ENCODED_SIZE(LOG_MAX_FRAME_SIZE) + 2];
+
+    while (0 < ring_count()) {
+
+        uint8_t num_args = ring_peek(3);
+        uint8_t record_size = LOG_RECORD_HEADER_SIZE + (2 * num_args);
+
+        frame[0] = LOG_FRAME_TYPE + ring_peek(0);
+        frame[1] = sequence;
+        frame[2] = ring_peek(1);
+        frame[3] = ring_peek(2);
+
+        for (uint8_t i = 0; i < (2 * num_args); i++) {
+            frame[4 + i] = ring_peek(LOG_RECORD_HEADER_SIZE + i);
+        }
+
+        uint8_t frame_size = 4 + (2 * num_args);
+        frame[frame_size] = frame_crc(frame, frame_size);
+        frame_size++;
+
+        // delimiters on both sides keep frames apart from anything else written
+        encoded[0] = COBS_DELIMITER;
+        uint8_t encoded_size = 1 + cobs_encode(frame, frame_size, &encoded[1]);
+        encoded[encoded_size++] = COBS_DELIMITER;
+
+        // never wait for the serial buffer to drain
+        if (encoded_size > Serial.availableForWrite()) {
+            return;
+        }
+
+        (void) Serial.write(encoded, encoded_size);
+
+        ring_tail = (ring_tail + record_size) % LOG_RING_SIZE;
+        sequence++;
+    }
+}
+
+#else
+
+void log_text(const char* fmt, ...) {
+
+    char line[LOG_LINE_SIZE];
+
+    // lines longer than the buffer are cut short
+    va_list args;
+    va_start(args, fmt);
+    (void) vsnprintf_P(line, sizeof(line), fmt, args);
+    va_end(args);
+
+    Serial.println(line);
+}
+
+
+void log_drain() {
+
+    // text is written as it is logged
+}
+
+#endif
+
+
+uint16_t log_num_dropped() {
+
+#if LOG_BINARY_ENABLED
+    return num_dropped;
+#else
+    return 0;
+#endif
+}
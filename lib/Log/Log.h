@@ -0,0 +1,151 @@
+/**
+* @brief: Contains macros to simplify logging
+* @file: Log.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include <string.h>
+
+#define LOG_LEVEL_NONE 0    // no logging
+#define LOG_LEVEL_ERROR 1   // unrecoverable failures
+#define LOG_LEVEL_WARN 2    // recoverable failures
+#define LOG_LEVEL_INFO 3    // normal operation
+
+// most verbose level compiled in, less important levels compile away
+// entirely (can be set with -D in build_flags)
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Log compact binary records into a ring buffer drained by log_drain()
+// instead of formatting text (0 to disable). Each record is sent as a COBS
+// frame with type LOG_FRAME_TYPE + level, a sequence number, the flash address
+// of the format string, the arguments as 16-bit words and a CRC-8, so the host
+// looks up the format string in the firmware image. 32-bit arguments take two
+// words, least significant first, as the format string's %l conversions
+// expect. Can be set with -D in build_flags.
+#ifndef LOG_BINARY_ENABLED
+#define LOG_BINARY_ENABLED 0
+#endif
+
+#define LOG_FRAME_TYPE 0x80     // frame type of binary records before adding the level
+#define LOG_MAX_ARGS 4          // maximum number of 16-bit argument words of a binary record
+#define LOG_RING_SIZE 128       // bytes of RAM buffering binary records
+#define LOG_LINE_SIZE 80        // longest formatted text line in bytes
+
+// Binary records are only written while they fit in the serial transmit
+// buffer so logging never blocks. Records that do not fit in the ring buffer
+// are dropped and counted.
+
+#if LOG_BINARY_ENABLED
+
+/**
+ * @brief Queues a binary log record
+ * 
+ * @param level: log level of the record
+ * @param fmt: format string in flash
+ * @param args: arguments of the format string as 16-bit words
+ * @param num_args: number of words
+ */
+void log_record(uint8_t level, const char* fmt, const uint16_t* args, uint8_t num_args);
+
+/**
+ * @brief Adds an argument of a binary log record as one or two 16-bit words
+ * 
+ * @param values: words of the record
+ * @param num_values: number of words so far, advanced past the argument
+ * @param arg: argument to add
+ */
+template <typename T>
+inline void log_add_arg(uint16_t* values, uint8_t& num_values, T arg) {
+
+    static_assert(4 >= sizeof(T), "log arguments must be at most 32 bits");
+
+    if constexpr (2 < sizeof(T)) {
+        values[num_values++] = (uint16_t)((uint32_t)arg & 0xFFFF);
+        values[num_values++] = (uint16_t)((uint32_t)arg >> 16);
+    }
+    else {
+        values[num_values++] = (uint16_t)arg;
+    }
+}
+
+/**
+ * @brief Queues a binary log record
+ * 
+ * @param level: log level of the record
+ * @param fmt: format string in flash
+ * @param args: arguments of the format string
+ */
+template <typename... Args>
+inline void log_binary(uint8_t level, const char* fmt, Args... args) {
+
+    // 32-bit arguments take two words
+    constexpr uint8_t num_words = (0 + ... + ((2 < sizeof(Args)) ? 2 : 1));
+    static_assert(LOG_MAX_ARGS >= num_words, "too many arguments to log");
+
+    uint16_t values[num_words + 1] = {0};
+    uint8_t num_values = 0;
+    (log_add_arg(values, num_values, args), ...);
+
+    log_record(level, fmt, values, num_values);
+}
+
+#define LOG_WRITE(level, prefix, fmt, ...) log_binary(level, PSTR(fmt), ##__VA_ARGS__);
+
+#else
+
+/**
+ * @brief Formats and writes a line of text to the serial port
+ * 
+ * Lines longer than LOG_LINE_SIZE are cut short.
+ * 
+ * @param fmt: printf style format string in flash
+ */
+void log_text(const char* fmt, ...);
+
+#define LOG_WRITE(level, prefix, fmt, ...) log_text(PSTR(prefix fmt), ##__VA_ARGS__);
+
+#endif
+
+/**
+ * @brief Writes queued binary log records to the serial port
+ * 
+ * Call when idle. Stops once the serial transmit buffer is full.
+ */
+void log_drain();
+
+/**
+ * @brief Gets the number of binary log records dropped
+ * 
+ * @return Number of dropped records
+ */
+uint16_t log_num_dropped();
+
+
+// printf style logging, e.g. INFO("Node %d is now vacant", node_id)
+#if LOG_LEVEL_INFO <= LOG_LEVEL
+#define INFO(fmt, ...) LOG_WRITE(LOG_LEVEL_INFO, "INFO: ", fmt, ##__VA_ARGS__)
+#else
+#define INFO(fmt, ...)
+#endif
+
+#if LOG_LEVEL_WARN <= LOG_LEVEL
+#define WARN(fmt, ...) LOG_WRITE(LOG_LEVEL_WARN, "WARN: ", fmt, ##__VA_ARGS__)
+#else
+#define WARN(fmt, ...)
+#endif
+
+#if LOG_LEVEL_ERROR <= LOG_LEVEL
+#define ERROR(fmt, ...) LOG_WRITE(LOG_LEVEL_ERROR, "ERROR: ", fmt, ##__VA_ARGS__)
+#else
+#define ERROR(fmt, ...)
+#endif
+
+#endif // _LOG_H_
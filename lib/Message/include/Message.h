@@ -0,0 +1,26 @@
+/**
+* @brief: Includes all required headers for the Message library
+* @file: Message.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _MESSAGE_H_
+#define _MESSAGE_H_
+
+#include "message.hpp"
+#include "bitmap.hpp"
+#include "sequencecache.hpp"
+#include "updatemessage.hpp"
+#include "aggregatemessage.hpp"
+#include "snapshotmessage.hpp"
+#include "beaconmessage.hpp"
+#include "statsmessage.hpp"
+#include "tracemessage.hpp"
+#include "querymessage.hpp"
+#include "configmessage.hpp"
+#include "messageview.hpp"
+#include "framequeue.hpp"
+#include "cobs.hpp"
+
+#endif // _MESSAGE_H_
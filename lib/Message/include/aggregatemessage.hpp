@@ -0,0 +1,133 @@
+/**
+* @brief: Contains the prototype of the AggregateMessage class.
+* @file: aggregatemessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _AGGREGATE_MESSAGE_HPP_
+#define _AGGREGATE_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "sequencecache.hpp"
+
+// maximum number of status entries that fit in one aggregate message
+#define AGGREGATE_MAX_ENTRIES ((MESSAGE_MAX_SIZE - MESSAGE_HEADER_SIZE - 1) / 2)
+
+// largest node ID that can be packed into an aggregate entry
+#define AGGREGATE_MAX_NODE_ID 0x7F
+
+#define AGGREGATE_NODE_ID_MASK 0x7F // bits of an entry holding the node ID
+#define AGGREGATE_VACANT_MASK 0x80  // bit of an entry holding the vacancy status
+
+
+// status of a single node within an aggregate message
+struct MESSAGE_PACKED aggregate_entry_t {
+    uint8_t status;     // node ID in the lower 7 bits and vacancy status in the most significant bit
+    uint8_t sequence;   // origin node's sequence number for the status
+};
+
+
+class MESSAGE_PACKED AggregateMessage : public Message {
+
+    private:
+
+        // number of valid entries
+        uint8_t num_entries = 0;
+
+        // status entries
+        aggregate_entry_t entries[AGGREGATE_MAX_ENTRIES] = {};
+
+
+    public:
+
+        /**
+         * @brief Constructs an AggregateMessage object
+         * 
+         * @param rx_id: ID of receiving node
+         * @param tx_id: ID of transmitting node
+         */
+        AggregateMessage(uint8_t rx_id, uint8_t tx_id);
+        AggregateMessage();
+
+        /**
+         * @brief Adds a node's status to the message
+         * 
+         * Adds a node's status to the message. If the node already has an
+         * entry, the existing entry is overwritten if the status is newer.
+         * 
+         * @param node_id: ID of node reporting its status
+         * @param is_vacant: Node's vacancy status
+         * @param sequence: Origin node's sequence number for the status
+         * @return True if successfully added. Otherwise false
+         */
+        bool add_entry(uint8_t node_id, bool is_vacant, uint8_t sequence);
+
+        /**
+         * @brief Adds all entries of another aggregate message to this message
+         * 
+         * @param msg: Aggregate message to merge entries from
+         * @return True if all entries were added. Otherwise false
+         */
+        bool merge(AggregateMessage* msg);
+
+        /**
+         * @brief Removes all entries from the message
+         */
+        void clear();
+
+        /**
+         * @brief Gets the number of entries in the message
+         * 
+         * @return Number of entries
+         */
+        uint8_t get_num_entries();
+
+        /**
+         * @brief Determines if no more new entries can be added
+         * 
+         * @return True if the message is full. Otherwise false
+         */
+        bool is_full();
+
+        /**
+         * @brief Gets the ID of the node of an entry
+         * 
+         * @param index: index of the entry
+         * @return ID of the node
+         */
+        uint8_t get_node_id(uint8_t index);
+
+        /**
+         * @brief Gets the vacancy status of the node of an entry
+         * 
+         * @param index: index of the entry
+         * @return True if the status is vacant. Otherwise false.
+         */
+        bool get_is_vacant(uint8_t index);
+
+        /**
+         * @brief Gets the origin node's sequence number of an entry
+         * 
+         * @param index: index of the entry
+         * @return Sequence number
+         */
+        uint8_t get_sequence(uint8_t index);
+
+        /**
+         * @brief Gets the number of bytes of the message that need to be transmitted
+         * 
+         * @return Size of the message in bytes
+         */
+        uint8_t get_size();
+};
+
+static_assert(2 == sizeof(aggregate_entry_t), "aggregate entry must match wire format");
+static_assert(MESSAGE_MAX_SIZE == sizeof(AggregateMessage), "aggregate message must fill one payload");
+
+
+#endif // _AGGREGATE_MESSAGE_HPP_
@@ -0,0 +1,95 @@
+/**
+* @brief: Contains the prototype of the BeaconMessage class.
+* @file: beaconmessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _BEACON_MESSAGE_HPP_
+#define _BEACON_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+
+
+class MESSAGE_PACKED BeaconMessage : public Message {
+
+    private:
+
+        uint8_t sequence = 0;   // sequence number of the superframe
+        uint8_t phase_ms = 0;   // length of the beacon phase at the start of the superframe
+        uint8_t slot_ms = 0;    // length of each transmit slot
+        uint8_t num_slots = 0;  // number of transmit slots in the superframe
+        uint8_t offset_ms = 0;  // time since the start of the superframe when sent
+
+
+    public:
+
+        /**
+         * @brief Constructs a BeaconMessage object
+         * 
+         * @param tx_id: ID of transmitting node
+         * @param sequence: sequence number of the superframe
+         * @param phase_ms: length of the beacon phase in milliseconds
+         * @param slot_ms: length of each transmit slot in milliseconds
+         * @param num_slots: number of transmit slots in the superframe
+         * @param offset_ms: time since the start of the superframe in milliseconds
+         */
+        BeaconMessage(uint8_t tx_id,
+                      uint8_t sequence,
+                      uint8_t phase_ms,
+                      uint8_t slot_ms,
+                      uint8_t num_slots,
+                      uint8_t offset_ms);
+        BeaconMessage();
+
+        /**
+         * @brief Gets the sequence number of the superframe
+         * 
+         * @return Sequence number
+         */
+        uint8_t get_sequence();
+
+        /**
+         * @brief Gets the length of the beacon phase
+         * 
+         * @return Length of the beacon phase in milliseconds
+         */
+        uint8_t get_phase_ms();
+
+        /**
+         * @brief Gets the length of each transmit slot
+         * 
+         * @return Length of a slot in milliseconds
+         */
+        uint8_t get_slot_ms();
+
+        /**
+         * @brief Gets the number of transmit slots in the superframe
+         * 
+         * @return Number of slots
+         */
+        uint8_t get_num_slots();
+
+        /**
+         * @brief Gets the time since the start of the superframe when sent
+         * 
+         * @return Offset in milliseconds
+         */
+        uint8_t get_offset_ms();
+
+        /**
+         * @brief Gets the length of the superframe
+         * 
+         * @return Length of the superframe in milliseconds
+         */
+        uint16_t get_superframe_ms();
+};
+
+static_assert((MESSAGE_HEADER_SIZE + 5) == sizeof(BeaconMessage), "beacon message must match wire format");
+
+
+#endif // _BEACON_MESSAGE_HPP_
@@ -0,0 +1,44 @@
+/**
+* @brief: Contains the prototype functions for bit-packed status maps.
+* @file: bitmap.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _BITMAP_HPP_
+#define _BITMAP_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// number of bytes required to hold a given number of bits
+#define BITMAP_SIZE(num_bits) (((num_bits) + 7) / 8)
+
+/**
+ * @brief Gets the value of a bit in a bitmap
+ * 
+ * @param bitmap: bitmap to read from
+ * @param index: index of the bit
+ * @return True if the bit is set. Otherwise false
+ */
+bool bitmap_get(const uint8_t* bitmap, uint16_t index);
+
+/**
+ * @brief Sets or clears a bit in a bitmap
+ * 
+ * @param bitmap: bitmap to write to
+ * @param index: index of the bit
+ * @param value: true to set the bit or false to clear it
+ */
+void bitmap_set(uint8_t* bitmap, uint16_t index, bool value);
+
+/**
+ * @brief Counts the number of set bits in a bitmap
+ * 
+ * @param bitmap: bitmap to count bits of
+ * @param num_bits: number of valid bits in the bitmap
+ * @return Number of set bits
+ */
+uint16_t bitmap_count(const uint8_t* bitmap, uint16_t num_bits);
+
+#endif // _BITMAP_HPP_
@@ -0,0 +1,51 @@
+/**
+* @brief: Contains the prototypes of the COBS framing functions.
+* @file: cobs.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _COBS_HPP_
+#define _COBS_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// byte separating COBS encoded frames on a serial link
+#define COBS_DELIMITER 0x00
+
+// largest number of bytes a buffer of the given size is encoded into
+#define COBS_ENCODED_SIZE(size) ((size) + ((size) / 254) + 1)
+
+
+/**
+ * @brief Encodes a buffer with consistent overhead byte stuffing (COBS)
+ * 
+ * The encoded bytes never contain COBS_DELIMITER.
+ * 
+ * @param src: bytes to encode
+ * @param size: number of bytes in src
+ * @param dst: buffer of at least COBS_ENCODED_SIZE(size) bytes for the encoded bytes
+ * @return Number of encoded bytes
+ */
+uint8_t cobs_encode(const uint8_t* src, uint8_t size, uint8_t* dst);
+
+/**
+ * @brief Decodes a COBS encoded buffer in place
+ * 
+ * @param buffer: encoded bytes without delimiters, replaced by the decoded bytes
+ * @param size: number of bytes in buffer
+ * @return Number of decoded bytes or 0 if the encoding is invalid
+ */
+uint8_t cobs_decode(uint8_t* buffer, uint8_t size);
+
+/**
+ * @brief Calculates the CRC-8 of a buffer
+ * 
+ * @param buffer: bytes to calculate the CRC of
+ * @param size: number of bytes in buffer
+ * @return CRC-8 of the buffer
+ */
+uint8_t frame_crc(const uint8_t* buffer, uint8_t size);
+
+#endif // _COBS_HPP_
@@ -0,0 +1,103 @@
+/**
+* @brief: Contains the prototype of the ConfigMessage class.
+* @file: configmessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _CONFIG_MESSAGE_HPP_
+#define _CONFIG_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+
+// value of a setting that keeps the node's current value
+#define CONFIG_KEEP 0xFF
+
+// version of the settings a node runs before it is ever configured, so hosts
+// start counting versions at 1
+#define CONFIG_VERSION_NONE 0
+
+
+// settings a node can be given over the air, CONFIG_KEEP in any of them keeps
+// the node's current value
+struct MESSAGE_PACKED config_settings_t {
+    uint8_t node_id;                // new ID of the target node applied on its next restart
+    uint8_t loop_delay_min_ms;      // minimum delay in the main loop in milliseconds
+    uint8_t loop_delay_max_ms;      // maximum delay in the main loop in milliseconds
+    uint8_t heartbeat_interval_s;   // time between heartbeats in seconds
+    uint8_t max_send_attempts;      // hardware retries per transmission (0-15)
+    uint8_t failed_send_delay;      // delay between hardware retries in 250 us steps (0-15)
+    uint8_t channel_checks_max;     // carrier checks before sending on a busy channel
+    uint8_t pa_level;               // highest power amplifier level (rf24_pa_dbm_e)
+    uint8_t data_rate;              // data rate of every link (rf24_datarate_e)
+};
+
+
+class MESSAGE_PACKED ConfigMessage : public Message {
+
+    private:
+
+        // ID of node the settings are for or BROADCAST_ID for every node
+        uint8_t target_id = 0;
+
+        // version of the settings, nodes ignore a version they already run
+        uint8_t version = CONFIG_VERSION_NONE;
+
+        // settings to apply
+        config_settings_t settings = {};
+
+
+    public:
+
+        /**
+         * @brief Constructs a ConfigMessage object
+         * 
+         * @param rx_id: ID of receiving node
+         * @param tx_id: ID of transmitting node
+         * @param target_id: ID of node the settings are for or BROADCAST_ID for every node
+         * @param version: version of the settings
+         * @param settings: settings to apply
+         */
+        ConfigMessage(uint8_t rx_id, uint8_t tx_id, uint8_t target_id, uint8_t version, config_settings_t settings);
+        ConfigMessage();
+
+        /**
+         * @brief Gets the ID of the node the settings are for
+         * 
+         * @return ID of the target node or BROADCAST_ID for every node
+         */
+        uint8_t get_target_id();
+
+        /**
+         * @brief Determines if the settings are for a node
+         * 
+         * @param node_id: ID of node
+         * @return True if the node is the target or every node is. Otherwise false
+         */
+        bool is_target(uint8_t node_id);
+
+        /**
+         * @brief Gets the version of the settings
+         * 
+         * @return Version of the settings
+         */
+        uint8_t get_version();
+
+        /**
+         * @brief Gets the settings to apply
+         * 
+         * @return Settings to apply
+         */
+        config_settings_t get_settings();
+};
+
+static_assert(9 == sizeof(config_settings_t), "config settings must match wire format");
+static_assert((MESSAGE_HEADER_SIZE + 2 + sizeof(config_settings_t)) == sizeof(ConfigMessage), "config message must match wire format");
+static_assert(MESSAGE_MAX_SIZE >= sizeof(ConfigMessage), "config message must fit in one payload");
+
+
+#endif // _CONFIG_MESSAGE_HPP_
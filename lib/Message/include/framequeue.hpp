@@ -0,0 +1,258 @@
+/**
+* @brief: Contains the FrameQueue class template.
+* @file: framequeue.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _FRAME_QUEUE_HPP_
+#define _FRAME_QUEUE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+
+// prevents the compiler from reordering memory accesses across this point
+#define FRAME_QUEUE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+
+/**
+ * @brief Fixed-capacity single-producer/single-consumer queue of radio frames
+ * 
+ * The producer (e.g. the radio's interrupt) only writes the head index and the
+ * consumer (e.g. the main loop) only writes the tail index, so neither side
+ * needs to disable interrupts. One slot is always left empty to tell a full
+ * queue from an empty one, so the queue holds CAPACITY - 1 frames.
+ * 
+ * @tparam CAPACITY: number of slots which must be a power of two (2-128)
+ */
+template <uint8_t CAPACITY>
+class FrameQueue {
+
+    static_assert(CAPACITY >= 2 && CAPACITY <= 128, "capacity must be 2-128");
+    static_assert(0 == (CAPACITY & (CAPACITY - 1)), "capacity must be a power of two");
+
+    private:
+
+        // frames, their sizes in bytes and the reading pipes they arrived on
+        uint8_t frames[CAPACITY][MESSAGE_MAX_SIZE];
+        uint8_t sizes[CAPACITY];
+        uint8_t pipes[CAPACITY];
+
+        volatile uint8_t head = 0;  // index of next slot to be written by the producer
+        volatile uint8_t tail = 0;  // index of next slot to be read by the consumer
+
+        // number of frames the producer could not queue
+        volatile uint16_t num_dropped = 0;
+
+        /**
+         * @brief Gets the slot index following the provided one
+         * 
+         * @param index: current slot index
+         * @return Next slot index
+         */
+        static uint8_t next(uint8_t index) {
+
+            return (index + 1) & (CAPACITY - 1);
+        }
+
+
+    public:
+
+        /**
+         * @brief Determines if there are no frames in the queue
+         * 
+         * @return True if the queue is empty. Otherwise false
+         */
+        bool is_empty() {
+
+            return this->head == this->tail;
+        }
+
+        /**
+         * @brief Determines if no more frames can be queued
+         * 
+         * @return True if the queue is full. Otherwise false
+         */
+        bool is_full() {
+
+            return next(this->head) == this->tail;
+        }
+
+        /**
+         * @brief Gets the number of frames in the queue
+         * 
+         * @return Number of frames
+         */
+        uint8_t get_count() {
+
+            return (this->head - this->tail) & (CAPACITY - 1);
+        }
+
+        /**
+         * @brief Gets the number of frames the producer could not queue
+         * 
+         * @return Number of dropped frames
+         */
+        uint16_t get_num_dropped() {
+
+            return this->num_dropped;
+        }
+
+        /**
+         * @brief Records that the producer could not queue a frame
+         * 
+         * @note Must only be called by the producer
+         */
+        void mark_dropped() {
+
+            this->num_dropped++;
+        }
+
+        /**
+         * @brief Gets the next free slot for the producer to write a frame into
+         * 
+         * @note Must only be called by the producer
+         * @return Slot to write into if the queue is not full. Otherwise NULL
+         */
+        uint8_t* reserve() {
+
+            if (true == this->is_full()) {
+                return NULL;
+            }
+
+            return this->frames[this->head];
+        }
+
+        /**
+         * @brief Publishes the frame written into the reserved slot
+         * 
+         * @note Must only be called by the producer after a successful reserve()
+         * @param size: number of bytes written into the slot
+         * @param pipe: reading pipe the frame arrived on
+         */
+        void commit(uint8_t size, uint8_t pipe) {
+
+            this->sizes[this->head] = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+            this->pipes[this->head] = pipe;
+
+            // frame must be written before it is published
+            FRAME_QUEUE_BARRIER();
+            this->head = next(this->head);
+        }
+
+        /**
+         * @brief Copies a frame into the queue
+         * 
+         * @note Must only be called by the producer
+         * @param frame: frame to queue
+         * @param size: size of frame in bytes
+         * @param pipe: reading pipe the frame arrived on
+         * @return True if the frame was queued. Otherwise false
+         */
+        bool push(const void* frame, uint8_t size, uint8_t pipe) {
+
+            uint8_t* slot = this->reserve();
+
+            if (NULL == slot) {
+                this->mark_dropped();
+                return false;
+            }
+
+            size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+            memset(slot, 0, MESSAGE_MAX_SIZE);
+            memcpy(slot, frame, size);
+            this->commit(size, pipe);
+
+            return true;
+        }
+
+        /**
+         * @brief Gets the oldest frame in the queue without removing it
+         * 
+         * @note Must only be called by the consumer
+         * @return Oldest frame if the queue is not empty. Otherwise NULL
+         */
+        const uint8_t* front() {
+
+            if (true == this->is_empty()) {
+                return NULL;
+            }
+
+            // frame must not be read before it is published
+            FRAME_QUEUE_BARRIER();
+            return this->frames[this->tail];
+        }
+
+        /**
+         * @brief Gets the size of the oldest frame in the queue
+         * 
+         * @note Must only be called by the consumer
+         * @return Size of the oldest frame in bytes or 0 if the queue is empty
+         */
+        uint8_t front_size() {
+
+            if (true == this->is_empty()) {
+                return 0;
+            }
+
+            return this->sizes[this->tail];
+        }
+
+        /**
+         * @brief Gets the reading pipe the oldest frame in the queue arrived on
+         * 
+         * @note Must only be called by the consumer
+         * @return Reading pipe of the oldest frame or 0 if the queue is empty
+         */
+        uint8_t front_pipe() {
+
+            if (true == this->is_empty()) {
+                return 0;
+            }
+
+            return this->pipes[this->tail];
+        }
+
+        /**
+         * @brief Removes the oldest frame from the queue
+         * 
+         * @note Must only be called by the consumer
+         */
+        void pop() {
+
+            if (true == this->is_empty()) {
+                return;
+            }
+
+            // frame must be done being read before the slot is released
+            FRAME_QUEUE_BARRIER();
+            this->tail = next(this->tail);
+        }
+
+        /**
+         * @brief Copies the oldest frame out of the queue and removes it
+         * 
+         * @note Must only be called by the consumer
+         * @param buffer: buffer to hold the frame
+         * @param size: size of buffer
+         * @return True if a frame was removed. Otherwise false
+         */
+        bool pop(void* buffer, uint8_t size) {
+
+            const uint8_t* frame = this->front();
+
+            if (NULL == frame) {
+                return false;
+            }
+
+            memcpy(buffer, frame, min(size, (uint8_t)MESSAGE_MAX_SIZE));
+            this->pop();
+
+            return true;
+        }
+};
+
+#endif // _FRAME_QUEUE_HPP_
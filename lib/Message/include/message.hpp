@@ -13,8 +13,33 @@
 
 #define MESSAGE_UNKNOWN 0
 #define MESSAGE_UPDATE 1
+#define MESSAGE_AGGREGATE 2
+#define MESSAGE_SNAPSHOT 3
+#define MESSAGE_BEACON 4
+#define MESSAGE_STATS 5
+#define MESSAGE_TRACE 6
+#define MESSAGE_QUERY 7
+#define MESSAGE_CONFIG 8
 
-class Message {
+// receiving node ID of messages meant for every node that hears them
+#define BROADCAST_ID 0xFF
+
+// radio address all nodes listen on for broadcast messages
+#define BROADCAST_ADDRESS 0xBEAC0A57
+
+// maximum size in bytes of a single radio payload
+#define MESSAGE_MAX_SIZE 32
+
+// size in bytes of the header shared by all messages
+#define MESSAGE_HEADER_SIZE 3
+
+// Message classes are transmitted as-is, so they must be packed, contain only
+// single byte fields and have no virtual functions. On the wire every message
+// starts with the header (rx_id, tx_id, msg_type) followed by the fields of
+// the message type in declaration order.
+#define MESSAGE_PACKED __attribute__((packed))
+
+class MESSAGE_PACKED Message {
 
     private:
 
@@ -42,6 +67,13 @@ class Message {
          */
         uint8_t get_rx_id();
 
+        /**
+         * @brief Sets the receiving node's ID
+         * 
+         * @param rx_id: ID of receiving node
+         */
+        void set_rx_id(uint8_t rx_id);
+
         /**
          * @brief Gets the transmitting node's ID
          * 
@@ -57,4 +89,6 @@ class Message {
         uint8_t get_type();
 };
 
+static_assert(MESSAGE_HEADER_SIZE == sizeof(Message), "message header must match wire format");
+
 #endif // _MESSAGE_HPP_
@@ -0,0 +1,154 @@
+/**
+* @brief: Contains the prototype of the MessageView class.
+* @file: messageview.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _MESSAGE_VIEW_HPP_
+#define _MESSAGE_VIEW_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "updatemessage.hpp"
+#include "aggregatemessage.hpp"
+#include "snapshotmessage.hpp"
+#include "beaconmessage.hpp"
+#include "statsmessage.hpp"
+#include "tracemessage.hpp"
+#include "querymessage.hpp"
+#include "configmessage.hpp"
+
+
+/**
+ * @brief Typed access to a received message without copying it
+ * 
+ * A view refers to a frame buffer owned by someone else, such as a slot of a
+ * receive queue. The buffer must be MESSAGE_MAX_SIZE bytes and must outlive
+ * the view.
+ */
+class MessageView {
+
+    private:
+
+        uint8_t* frame = NULL;  // received frame
+        uint8_t size = 0;       // number of bytes received
+
+
+    public:
+
+        /**
+         * @brief Constructs a MessageView object
+         * 
+         * @param frame: buffer of MESSAGE_MAX_SIZE bytes holding the frame
+         * @param size: number of bytes received
+         */
+        MessageView(uint8_t* frame, uint8_t size);
+        MessageView();
+
+        /**
+         * @brief Determines if the view refers to a complete message header
+         * 
+         * @return True if the view is valid. Otherwise false
+         */
+        bool is_valid();
+
+        /**
+         * @brief Gets the number of bytes received
+         * 
+         * @return Size of the frame in bytes
+         */
+        uint8_t get_size();
+
+        /**
+         * @brief Gets the message header of the frame
+         * 
+         * @return Header of the frame if valid. Otherwise NULL
+         */
+        Message* header();
+
+        /**
+         * @brief Gets the type of message
+         * 
+         * @return Type of message or MESSAGE_UNKNOWN if the view is not valid
+         */
+        uint8_t get_type();
+
+        /**
+         * @brief Gets the frame as an update message
+         * 
+         * @return Update message if the frame is one. Otherwise NULL
+         */
+        UpdateMessage* as_update();
+
+        /**
+         * @brief Gets the frame as an aggregate message
+         * 
+         * @return Aggregate message if the frame is one. Otherwise NULL
+         */
+        AggregateMessage* as_aggregate();
+
+        /**
+         * @brief Gets the frame as a snapshot message
+         * 
+         * @return Snapshot message if the frame is one. Otherwise NULL
+         */
+        SnapshotMessage* as_snapshot();
+
+        /**
+         * @brief Gets the frame as a beacon message
+         * 
+         * @return Beacon message if the frame is one. Otherwise NULL
+         */
+        BeaconMessage* as_beacon();
+
+        /**
+         * @brief Gets the frame as a stats message
+         * 
+         * @return Stats message if the frame is one. Otherwise NULL
+         */
+        StatsMessage* as_stats();
+
+        /**
+         * @brief Gets the frame as a trace message
+         * 
+         * @return Trace message if the frame is one. Otherwise NULL
+         */
+        TraceMessage* as_trace();
+
+        /**
+         * @brief Gets the frame as a query message
+         * 
+         * @return Query message if the frame is one. Otherwise NULL
+         */
+        QueryMessage* as_query();
+
+        /**
+         * @brief Gets the frame as a config message
+         * 
+         * @return Config message if the frame is a complete one. Otherwise NULL
+         */
+        ConfigMessage* as_config();
+};
+
+
+// handles received messages of a particular type
+struct message_handler_t {
+    uint8_t msg_type;                   // type of message handled
+    void (*handle)(MessageView* msg);   // function handling the message
+};
+
+/**
+ * @brief Calls the handler registered for the type of a received message
+ * 
+ * @param msg: received message
+ * @param handlers: handlers for each supported message type
+ * @param num_handlers: number of handlers
+ * @return True if a handler was called. Otherwise false
+ */
+bool dispatch_message(MessageView* msg, const message_handler_t* handlers, uint8_t num_handlers);
+
+#endif // _MESSAGE_VIEW_HPP_
@@ -0,0 +1,101 @@
+/**
+* @brief: Contains the prototype of the QueryMessage class.
+* @file: querymessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _QUERY_MESSAGE_HPP_
+#define _QUERY_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "bitmap.hpp"
+
+// maximum number of bytes of the target bitmap in one query message
+#define QUERY_MAX_BYTES (MESSAGE_MAX_SIZE - MESSAGE_HEADER_SIZE - 2)
+
+// maximum number of nodes that can be queried by one query message
+#define QUERY_MAX_NODES (QUERY_MAX_BYTES * 8)
+
+
+class MESSAGE_PACKED QueryMessage : public Message {
+
+    private:
+
+        // ID of node represented by the first bit of the bitmap
+        uint8_t first_node_id = 0;
+
+        // number of nodes represented by the bitmap
+        uint8_t num_nodes = 0;
+
+        // nodes asked to report their status with one bit per node
+        uint8_t target_bitmap[QUERY_MAX_BYTES] = {0};
+
+
+    public:
+
+        /**
+         * @brief Constructs a QueryMessage object with no targets
+         * 
+         * @param rx_id: ID of receiving node
+         * @param tx_id: ID of transmitting node
+         * @param first_node_id: ID of first node covered by the query
+         * @param num_nodes: number of consecutive nodes covered by the query
+         */
+        QueryMessage(uint8_t rx_id, uint8_t tx_id, uint8_t first_node_id, uint8_t num_nodes);
+        QueryMessage();
+
+        /**
+         * @brief Gets the ID of the first node covered by the query
+         * 
+         * @return ID of the first node
+         */
+        uint8_t get_first_node_id();
+
+        /**
+         * @brief Gets the number of nodes covered by the query
+         * 
+         * @return Number of nodes
+         */
+        uint8_t get_num_nodes();
+
+        /**
+         * @brief Sets whether a node is asked to report its status
+         * 
+         * @param node_id: ID of node
+         * @param is_queried: true to ask the node for its status
+         * @return True if successfully set. Otherwise false
+         */
+        bool set_is_queried(uint8_t node_id, bool is_queried);
+
+        /**
+         * @brief Determines if a node is asked to report its status
+         * 
+         * @param node_id: ID of node
+         * @return True if the node is a target. Otherwise false
+         */
+        bool get_is_queried(uint8_t node_id);
+
+        /**
+         * @brief Determines if no node is asked to report its status
+         * 
+         * @return True if the query has no targets. Otherwise false
+         */
+        bool is_empty();
+
+        /**
+         * @brief Gets the number of bytes of the message that need to be transmitted
+         * 
+         * @return Size of the message in bytes
+         */
+        uint8_t get_size();
+};
+
+static_assert(MESSAGE_MAX_SIZE == sizeof(QueryMessage), "query message must fill one payload");
+
+
+#endif // _QUERY_MESSAGE_HPP_
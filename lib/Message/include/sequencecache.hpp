@@ -0,0 +1,163 @@
+/**
+* @brief: Contains the SequenceCache class template and sequence number helpers.
+* @file: sequencecache.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _SEQUENCE_CACHE_HPP_
+#define _SEQUENCE_CACHE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// sequence number a node starts counting from after it powers up. It is
+// skipped when the counter wraps so receivers always accept it as a restart.
+#define SEQUENCE_RESTART 0
+
+
+/**
+ * @brief Gets the sequence number following the provided one
+ * 
+ * @param sequence: current sequence number
+ * @return Next sequence number
+ */
+inline uint8_t sequence_next(uint8_t sequence) {
+
+    return (UINT8_MAX == sequence) ? (SEQUENCE_RESTART + 1) : (sequence + 1);
+}
+
+
+/**
+ * @brief Determines if a sequence number comes after another
+ * 
+ * Uses serial number arithmetic so the comparison still holds when the
+ * counter wraps, as long as the numbers are within half the range.
+ * 
+ * @param sequence: sequence number to check
+ * @param last_sequence: most recently accepted sequence number
+ * @return True if sequence is newer. Otherwise false
+ */
+inline bool sequence_is_newer(uint8_t sequence, uint8_t last_sequence) {
+
+    return 0 < (int8_t)(sequence - last_sequence);
+}
+
+
+/**
+ * @brief Remembers the last sequence number seen from each origin node
+ * 
+ * Used to drop duplicate and reordered stale statuses. When more origins are
+ * seen than fit, the entry added longest ago is replaced, which only means
+ * that origin's next status is accepted unchecked.
+ * 
+ * @tparam CAPACITY: number of origin nodes remembered (1-254)
+ */
+template <uint8_t CAPACITY>
+class SequenceCache {
+
+    static_assert(CAPACITY >= 1 && CAPACITY < UINT8_MAX, "capacity must be 1-254");
+
+    private:
+
+        uint8_t origin_ids[CAPACITY];   // origin node of each entry
+        uint8_t sequences[CAPACITY];    // last accepted sequence number of each entry
+
+        uint8_t num_origins = 0;    // number of valid entries
+        uint8_t next_replace = 0;   // entry replaced when the cache is full
+
+
+    public:
+
+        /**
+         * @brief Determines if a sequence number is new for its origin without recording it
+         * 
+         * @param origin_id: ID of node the status originated from
+         * @param sequence: sequence number of the status
+         * @return True if the status is new. False if it is a duplicate or stale
+         */
+        bool is_new(uint8_t origin_id, uint8_t sequence) {
+
+            uint8_t last_sequence = 0;
+
+            // nothing seen from the origin yet
+            if (false == this->get_last(origin_id, &last_sequence)) {
+                return true;
+            }
+
+            // only a restarted origin may go backwards
+            return true == sequence_is_newer(sequence, last_sequence)
+                || (SEQUENCE_RESTART == sequence && SEQUENCE_RESTART != last_sequence);
+        }
+
+        /**
+         * @brief Records a sequence number if it is new for its origin
+         * 
+         * @param origin_id: ID of node the status originated from
+         * @param sequence: sequence number of the status
+         * @return True if the status is new. False if it is a duplicate or stale
+         */
+        bool accept(uint8_t origin_id, uint8_t sequence) {
+
+            if (false == this->is_new(origin_id, sequence)) {
+                return false;
+            }
+
+            for (uint8_t i = 0; i < this->num_origins; i++) {
+
+                if (origin_id == this->origin_ids[i]) {
+                    this->sequences[i] = sequence;
+                    return true;
+                }
+            }
+
+            uint8_t index = this->num_origins;
+
+            // forget the oldest origin to make room
+            if (CAPACITY <= index) {
+                index = this->next_replace;
+                this->next_replace = (this->next_replace + 1) % CAPACITY;
+            }
+
+            else {
+                this->num_origins++;
+            }
+
+            this->origin_ids[index] = origin_id;
+            this->sequences[index] = sequence;
+
+            return true;
+        }
+
+        /**
+         * @brief Gets the last sequence number accepted from an origin
+         * 
+         * @param origin_id: ID of node the status originated from
+         * @param sequence: set to the last accepted sequence number
+         * @return True if the origin is remembered. Otherwise false
+         */
+        bool get_last(uint8_t origin_id, uint8_t* sequence) {
+
+            for (uint8_t i = 0; i < this->num_origins; i++) {
+
+                if (origin_id == this->origin_ids[i]) {
+                    *sequence = this->sequences[i];
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Forgets every origin
+         */
+        void clear() {
+
+            this->num_origins = 0;
+            this->next_replace = 0;
+        }
+};
+
+
+#endif // _SEQUENCE_CACHE_HPP_
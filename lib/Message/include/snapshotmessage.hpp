@@ -0,0 +1,124 @@
+/**
+* @brief: Contains the prototype of the SnapshotMessage class.
+* @file: snapshotmessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _SNAPSHOT_MESSAGE_HPP_
+#define _SNAPSHOT_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "bitmap.hpp"
+
+// maximum number of bytes of the status bitmap in one snapshot message
+#define SNAPSHOT_MAX_BYTES (MESSAGE_MAX_SIZE - MESSAGE_HEADER_SIZE - 3)
+
+// maximum number of nodes whose status fits in one snapshot message
+#define SNAPSHOT_MAX_NODES (SNAPSHOT_MAX_BYTES * 4)
+
+
+class MESSAGE_PACKED SnapshotMessage : public Message {
+
+    private:
+
+        // sequence number of the snapshot among those of its sender
+        uint8_t sequence = 0;
+
+        // ID of node represented by the first bits of the bitmap
+        uint8_t first_node_id = 0;
+
+        // number of nodes represented by the bitmap
+        uint8_t num_nodes = 0;
+
+        // status of consecutive nodes with two bits per node, if the
+        // snapshot has a status of the node followed by its vacancy
+        uint8_t status_bitmap[SNAPSHOT_MAX_BYTES] = {0};
+
+
+    public:
+
+        /**
+         * @brief Constructs a SnapshotMessage object
+         * 
+         * @param rx_id: ID of receiving node
+         * @param tx_id: ID of transmitting node
+         * @param sequence: sender's sequence number for the snapshot
+         * @param first_node_id: ID of first node in the snapshot
+         * @param num_nodes: number of consecutive nodes in the snapshot
+         */
+        SnapshotMessage(uint8_t rx_id, uint8_t tx_id, uint8_t sequence, uint8_t first_node_id, uint8_t num_nodes);
+        SnapshotMessage();
+
+        /**
+         * @brief Gets the sender's sequence number for the snapshot
+         * 
+         * @return Sequence number
+         */
+        uint8_t get_sequence();
+
+        /**
+         * @brief Gets the ID of the first node in the snapshot
+         * 
+         * @return ID of the first node
+         */
+        uint8_t get_first_node_id();
+
+        /**
+         * @brief Gets the number of nodes in the snapshot
+         * 
+         * @return Number of nodes
+         */
+        uint8_t get_num_nodes();
+
+        /**
+         * @brief Determines if a node is in the range of the snapshot
+         * 
+         * @param node_id: ID of node
+         * @return True if the node is in the snapshot. Otherwise false
+         */
+        bool is_in_snapshot(uint8_t node_id);
+
+        /**
+         * @brief Determines if the snapshot has a status of a node
+         * 
+         * Nodes in the range of the snapshot only have a status once one is set.
+         * 
+         * @param node_id: ID of node
+         * @return True if the node has a status. Otherwise false
+         */
+        bool has_status(uint8_t node_id);
+
+        /**
+         * @brief Sets the vacancy status of a node in the snapshot
+         * 
+         * @param node_id: ID of node
+         * @param is_vacant: Node's vacancy status
+         * @return True if successfully set. Otherwise false
+         */
+        bool set_is_vacant(uint8_t node_id, bool is_vacant);
+
+        /**
+         * @brief Gets the vacancy status of a node in the snapshot
+         * 
+         * @param node_id: ID of node
+         * @return True if the status is vacant. Otherwise false.
+         */
+        bool get_is_vacant(uint8_t node_id);
+
+        /**
+         * @brief Gets the number of bytes of the message that need to be transmitted
+         * 
+         * @return Size of the message in bytes
+         */
+        uint8_t get_size();
+};
+
+static_assert(MESSAGE_MAX_SIZE == sizeof(SnapshotMessage), "snapshot message must fill one payload");
+
+
+#endif // _SNAPSHOT_MESSAGE_HPP_
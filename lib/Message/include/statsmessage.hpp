@@ -0,0 +1,82 @@
+/**
+* @brief: Contains the prototype of the StatsMessage class.
+* @file: statsmessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _STATS_MESSAGE_HPP_
+#define _STATS_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+
+// maximum number of 16-bit counters that fit in one stats message
+#define STATS_MAX_COUNTERS ((MESSAGE_MAX_SIZE - MESSAGE_HEADER_SIZE - 2) / 2)
+
+
+class MESSAGE_PACKED StatsMessage : public Message {
+
+    private:
+
+        // ID of node the counters belong to
+        uint8_t node_id = 0;
+
+        // number of valid counters
+        uint8_t num_counters = 0;
+
+        // counters with the least significant byte first
+        uint8_t counters[2 * STATS_MAX_COUNTERS] = {0};
+
+
+    public:
+
+        /**
+         * @brief Constructs a StatsMessage object
+         * 
+         * @param rx_id: ID of receiving node
+         * @param tx_id: ID of transmitting node
+         * @param node_id: ID of node the counters belong to
+         * @param counters: counter values
+         * @param num_counters: number of counters (at most STATS_MAX_COUNTERS)
+         */
+        StatsMessage(uint8_t rx_id, uint8_t tx_id, uint8_t node_id, const uint16_t* counters, uint8_t num_counters);
+        StatsMessage();
+
+        /**
+         * @brief Gets the ID of the node the counters belong to
+         * 
+         * @return ID of the node
+         */
+        uint8_t get_node_id();
+
+        /**
+         * @brief Gets the number of counters in the message
+         * 
+         * @return Number of counters
+         */
+        uint8_t get_num_counters();
+
+        /**
+         * @brief Gets the value of a counter
+         * 
+         * @param index: index of the counter
+         * @return Value of the counter. Otherwise 0 if the index is invalid
+         */
+        uint16_t get_counter(uint8_t index);
+
+        /**
+         * @brief Gets the number of bytes of the message that need to be transmitted
+         * 
+         * @return Size of the message in bytes
+         */
+        uint8_t get_size();
+};
+
+static_assert(MESSAGE_MAX_SIZE >= sizeof(StatsMessage), "stats message must fit in one payload");
+
+
+#endif // _STATS_MESSAGE_HPP_
@@ -0,0 +1,118 @@
+/**
+* @brief: Contains the prototype of the TraceMessage class.
+* @file: tracemessage.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _TRACE_MESSAGE_HPP_
+#define _TRACE_MESSAGE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+
+// maximum number of hops recorded in one trace message
+#define TRACE_MAX_HOPS ((MESSAGE_MAX_SIZE - MESSAGE_HEADER_SIZE - 3) / sizeof(trace_hop_t))
+
+
+// time a status spent at a single node on its way to the base station
+struct MESSAGE_PACKED trace_hop_t {
+    uint8_t node_id;    // ID of the node
+    uint8_t delay_lo;   // least significant byte of the delay in milliseconds
+    uint8_t delay_hi;   // most significant byte of the delay in milliseconds
+};
+
+
+class MESSAGE_PACKED TraceMessage : public Message {
+
+    private:
+
+        // ID of node the traced status originated from
+        uint8_t origin_id = 0;
+
+        // origin node's sequence number of the traced status
+        uint8_t sequence = 0;
+
+        // number of valid hops
+        uint8_t num_hops = 0;
+
+        // hops in the order they were passed
+        trace_hop_t hops[TRACE_MAX_HOPS] = {};
+
+
+    public:
+
+        /**
+         * @brief Constructs a TraceMessage object
+         * 
+         * @param rx_id: ID of receiving node
+         * @param tx_id: ID of transmitting node
+         * @param origin_id: ID of node the traced status originated from
+         * @param sequence: origin node's sequence number of the traced status
+         */
+        TraceMessage(uint8_t rx_id, uint8_t tx_id, uint8_t origin_id, uint8_t sequence);
+        TraceMessage();
+
+        /**
+         * @brief Records the time the status spent at a node
+         * 
+         * @param node_id: ID of the node
+         * @param delay_ms: time from the status arriving at, or originating
+         *      on, the node until it was sent on (saturates at 65535)
+         * @return True if successfully added. Otherwise false if the message is full
+         */
+        bool add_hop(uint8_t node_id, uint32_t delay_ms);
+
+        /**
+         * @brief Gets the ID of the node the traced status originated from
+         * 
+         * @return ID of the node
+         */
+        uint8_t get_origin_id();
+
+        /**
+         * @brief Gets the origin node's sequence number of the traced status
+         * 
+         * @return Sequence number
+         */
+        uint8_t get_sequence();
+
+        /**
+         * @brief Gets the number of hops in the message
+         * 
+         * @return Number of hops
+         */
+        uint8_t get_num_hops();
+
+        /**
+         * @brief Gets the ID of the node of a hop
+         * 
+         * @param index: index of the hop
+         * @return ID of the node
+         */
+        uint8_t get_hop_node_id(uint8_t index);
+
+        /**
+         * @brief Gets the time the status spent at the node of a hop
+         * 
+         * @param index: index of the hop
+         * @return Delay in milliseconds
+         */
+        uint16_t get_hop_delay_ms(uint8_t index);
+
+        /**
+         * @brief Gets the number of bytes of the message that need to be transmitted
+         * 
+         * @return Size of the message in bytes
+         */
+        uint8_t get_size();
+};
+
+static_assert(3 == sizeof(trace_hop_t), "trace hop must match wire format");
+static_assert(MESSAGE_MAX_SIZE >= sizeof(TraceMessage), "trace message must fit in one payload");
+
+
+#endif // _TRACE_MESSAGE_HPP_
@@ -15,12 +15,13 @@
 #include "message.hpp"
 
 
-class UpdateMessage : public Message {
+class MESSAGE_PACKED UpdateMessage : public Message {
 
     private:
 
         uint8_t node_id = 0;
         uint8_t is_vacant = true;
+        uint8_t sequence = 0;   // origin node's sequence number for the status
 
 
     public:
@@ -32,8 +33,9 @@ class UpdateMessage : public Message {
          * @param tx_id: ID of transmitting node
          * @param node_id: ID of node reporting its status
          * @param is_vacant: Node's vacancy status
+         * @param sequence: Origin node's sequence number for the status
          */
-        UpdateMessage(uint8_t rx_id, uint8_t tx_id, uint8_t node_id, bool is_vacant);
+        UpdateMessage(uint8_t rx_id, uint8_t tx_id, uint8_t node_id, bool is_vacant, uint8_t sequence);
         UpdateMessage();
 
         /**
@@ -49,7 +51,16 @@ class UpdateMessage : public Message {
          * @return True if the status is vacant. Otherwise false.
          */
         bool get_is_vacant();
+
+        /**
+         * @brief Gets the origin node's sequence number for the status
+         * 
+         * @return Sequence number
+         */
+        uint8_t get_sequence();
 };
 
+static_assert((MESSAGE_HEADER_SIZE + 3) == sizeof(UpdateMessage), "update message must match wire format");
+
 
 #endif // _UPDATE_MESSAGE_HPP_
@@ -0,0 +1,125 @@
+/**
+* @brief: Contains the implementation of the AggregateMessage class.
+* @file: aggregatemessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "aggregatemessage.hpp"
+
+
+AggregateMessage::AggregateMessage() : Message() {
+
+    this->clear();
+}
+
+
+AggregateMessage::AggregateMessage(uint8_t rx_id,
+                                   uint8_t tx_id) : Message(rx_id, tx_id, MESSAGE_AGGREGATE) {
+
+    this->clear();
+}
+
+
+bool AggregateMessage::add_entry(uint8_t node_id, bool is_vacant, uint8_t sequence) {
+
+    // node ID does not fit in an entry
+    if (AGGREGATE_MAX_NODE_ID < node_id) {
+        return false;
+    }
+
+    uint8_t entry = node_id | ((true == is_vacant) ? AGGREGATE_VACANT_MASK : 0);
+
+    // overwrite existing entry for the node with the newer status
+    for (uint8_t i = 0; i < this->num_entries; i++) {
+
+        if (node_id == (this->entries[i].status & AGGREGATE_NODE_ID_MASK)) {
+
+            if (true == sequence_is_newer(sequence, this->entries[i].sequence) || SEQUENCE_RESTART == sequence) {
+                this->entries[i].status = entry;
+                this->entries[i].sequence = sequence;
+            }
+
+            return true;
+        }
+    }
+
+    // no room for a new entry
+    if (true == this->is_full()) {
+        return false;
+    }
+
+    this->entries[this->num_entries].status = entry;
+    this->entries[this->num_entries].sequence = sequence;
+    this->num_entries++;
+
+    return true;
+}
+
+
+bool AggregateMessage::merge(AggregateMessage* msg) {
+
+    bool is_merged = true;
+
+    for (uint8_t i = 0; i < msg->get_num_entries(); i++) {
+
+        if (false == this->add_entry(msg->get_node_id(i), msg->get_is_vacant(i), msg->get_sequence(i))) {
+            is_merged = false;
+        }
+    }
+
+    return is_merged;
+}
+
+
+void AggregateMessage::clear() {
+
+    this->num_entries = 0;
+    memset(this->entries, 0, sizeof(this->entries));
+}
+
+
+uint8_t AggregateMessage::get_num_entries() {
+
+    // guard against a corrupted entry count
+    if (AGGREGATE_MAX_ENTRIES < this->num_entries) {
+        return AGGREGATE_MAX_ENTRIES;
+    }
+
+    return this->num_entries;
+}
+
+
+bool AggregateMessage::is_full() {
+
+    return AGGREGATE_MAX_ENTRIES <= this->num_entries;
+}
+
+
+uint8_t AggregateMessage::get_node_id(uint8_t index) {
+
+    return this->entries[index].status & AGGREGATE_NODE_ID_MASK;
+}
+
+
+bool AggregateMessage::get_is_vacant(uint8_t index) {
+
+    return 0 != (this->entries[index].status & AGGREGATE_VACANT_MASK);
+}
+
+
+uint8_t AggregateMessage::get_sequence(uint8_t index) {
+
+    return this->entries[index].sequence;
+}
+
+
+uint8_t AggregateMessage::get_size() {
+
+    return sizeof(*this) - sizeof(this->entries) + (this->get_num_entries() * sizeof(aggregate_entry_t));
+}
@@ -0,0 +1,74 @@
+/**
+* @brief: Contains the implementation of the BeaconMessage class.
+* @file: beaconmessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "beaconmessage.hpp"
+
+
+BeaconMessage::BeaconMessage() : Message() {
+
+    this->sequence = 0;
+    this->phase_ms = 0;
+    this->slot_ms = 0;
+    this->num_slots = 0;
+    this->offset_ms = 0;
+}
+
+
+BeaconMessage::BeaconMessage(uint8_t tx_id,
+                             uint8_t sequence,
+                             uint8_t phase_ms,
+                             uint8_t slot_ms,
+                             uint8_t num_slots,
+                             uint8_t offset_ms) : Message(BROADCAST_ID, tx_id, MESSAGE_BEACON) {
+
+    this->sequence = sequence;
+    this->phase_ms = phase_ms;
+    this->slot_ms = slot_ms;
+    this->num_slots = num_slots;
+    this->offset_ms = offset_ms;
+}
+
+
+uint8_t BeaconMessage::get_sequence() {
+
+    return this->sequence;
+}
+
+
+uint8_t BeaconMessage::get_phase_ms() {
+
+    return this->phase_ms;
+}
+
+
+uint8_t BeaconMessage::get_slot_ms() {
+
+    return this->slot_ms;
+}
+
+
+uint8_t BeaconMessage::get_num_slots() {
+
+    return this->num_slots;
+}
+
+
+uint8_t BeaconMessage::get_offset_ms() {
+
+    return this->offset_ms;
+}
+
+
+uint16_t BeaconMessage::get_superframe_ms() {
+
+    return this->phase_ms + ((uint16_t)this->num_slots * this->slot_ms);
+}
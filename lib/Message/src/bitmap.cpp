@@ -0,0 +1,52 @@
+/**
+* @brief: Contains the implementation of the functions for bit-packed status maps.
+* @file: bitmap.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "bitmap.hpp"
+
+
+bool bitmap_get(const uint8_t* bitmap, uint16_t index) {
+
+    return 0 != (bitmap[index >> 3] & (1 << (index & 0x07)));
+}
+
+
+void bitmap_set(uint8_t* bitmap, uint16_t index, bool value) {
+
+    uint8_t mask = 1 << (index & 0x07);
+
+    if (true == value) {
+        bitmap[index >> 3] |= mask;
+    }
+
+    else {
+        bitmap[index >> 3] &= ~mask;
+    }
+}
+
+
+uint16_t bitmap_count(const uint8_t* bitmap, uint16_t num_bits) {
+
+    uint16_t count = 0;
+    uint16_t num_bytes = num_bits >> 3;
+
+    // count whole bytes
+    for (uint16_t i = 0; i < num_bytes; i++) {
+        count += __builtin_popcount(bitmap[i]);
+    }
+
+    // count remaining bits of partial byte
+    uint8_t remaining_bits = num_bits & 0x07;
+    if (0 < remaining_bits) {
+        count += __builtin_popcount(bitmap[num_bytes] & ((1 << remaining_bits) - 1));
+    }
+
+    return count;
+}
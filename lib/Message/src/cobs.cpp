@@ -0,0 +1,86 @@
+/**
+* @brief: Contains the implementation of the COBS framing functions.
+* @file: cobs.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <util/crc16.h>
+
+// local dependencies
+#include "cobs.hpp"
+
+
+uint8_t frame_crc(const uint8_t* buffer, uint8_t size) {
+
+    uint8_t crc = 0;
+
+    for (uint8_t i = 0; i < size; i++) {
+        crc = _crc8_ccitt_update(crc, buffer[i]);
+    }
+
+    return crc;
+}
+
+
+uint8_t cobs_encode(const uint8_t* src, uint8_t size, uint8_t* dst) {
+
+    uint8_t code_index = 0;
+    uint8_t dst_index = 1;
+    uint8_t code = 1;
+
+    for (uint8_t i = 0; i < size; i++) {
+
+        // zeros are replaced by the distance to the next zero
+        if (0 == src[i]) {
+            dst[code_index] = code;
+            code_index = dst_index++;
+            code = 1;
+            continue;
+        }
+
+        dst[dst_index++] = src[i];
+        code++;
+
+        // longest run without a zero
+        if (0xFF == code) {
+            dst[code_index] = code;
+            code_index = dst_index++;
+            code = 1;
+        }
+    }
+
+    dst[code_index] = code;
+
+    return dst_index;
+}
+
+
+uint8_t cobs_decode(uint8_t* buffer, uint8_t size) {
+
+    uint8_t src_index = 0;
+    uint8_t dst_index = 0;
+
+    while (src_index < size) {
+
+        uint8_t code = buffer[src_index++];
+
+        // code points past the end of the frame
+        if (0 == code || size < (src_index + code - 1)) {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            buffer[dst_index++] = buffer[src_index++];
+        }
+
+        // a zero was removed unless the run was full or the frame ended
+        if (0xFF != code && src_index < size) {
+            buffer[dst_index++] = 0;
+        }
+    }
+
+    return dst_index;
+}
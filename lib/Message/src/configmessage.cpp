@@ -0,0 +1,57 @@
+/**
+* @brief: Contains the implementation of the ConfigMessage class.
+* @file: configmessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "configmessage.hpp"
+
+
+ConfigMessage::ConfigMessage() : Message() {
+
+    this->target_id = 0;
+    this->version = CONFIG_VERSION_NONE;
+    memset(&this->settings, CONFIG_KEEP, sizeof(this->settings));
+}
+
+
+ConfigMessage::ConfigMessage(uint8_t rx_id,
+                             uint8_t tx_id,
+                             uint8_t target_id,
+                             uint8_t version,
+                             config_settings_t settings) : Message(rx_id, tx_id, MESSAGE_CONFIG) {
+
+    this->target_id = target_id;
+    this->version = version;
+    this->settings = settings;
+}
+
+
+uint8_t ConfigMessage::get_target_id() {
+
+    return this->target_id;
+}
+
+
+bool ConfigMessage::is_target(uint8_t node_id) {
+
+    return BROADCAST_ID == this->target_id || node_id == this->target_id;
+}
+
+
+uint8_t ConfigMessage::get_version() {
+
+    return this->version;
+}
+
+
+config_settings_t ConfigMessage::get_settings() {
+
+    return this->settings;
+}
@@ -0,0 +1,198 @@
+/**
+* @brief: Contains the implementation of the MessageView class.
+* @file: messageview.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "messageview.hpp"
+
+
+MessageView::MessageView() {
+
+    this->frame = NULL;
+    this->size = 0;
+}
+
+
+MessageView::MessageView(uint8_t* frame, uint8_t size) {
+
+    this->frame = frame;
+    this->size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+}
+
+
+bool MessageView::is_valid() {
+
+    return NULL != this->frame && MESSAGE_HEADER_SIZE <= this->size;
+}
+
+
+uint8_t MessageView::get_size() {
+
+    return this->size;
+}
+
+
+Message* MessageView::header() {
+
+    if (false == this->is_valid()) {
+        return NULL;
+    }
+
+    return reinterpret_cast<Message*>(this->frame);
+}
+
+
+uint8_t MessageView::get_type() {
+
+    if (false == this->is_valid()) {
+        return MESSAGE_UNKNOWN;
+    }
+
+    return this->header()->get_type();
+}
+
+
+UpdateMessage* MessageView::as_update() {
+
+    // frame is not a complete update message
+    if (MESSAGE_UPDATE != this->get_type() || sizeof(UpdateMessage) > this->size) {
+        return NULL;
+    }
+
+    return reinterpret_cast<UpdateMessage*>(this->frame);
+}
+
+
+AggregateMessage* MessageView::as_aggregate() {
+
+    // frame is not an aggregate message
+    if (MESSAGE_AGGREGATE != this->get_type()) {
+        return NULL;
+    }
+
+    AggregateMessage* msg = reinterpret_cast<AggregateMessage*>(this->frame);
+
+    // frame is missing some of its entries
+    if (msg->get_size() > this->size) {
+        return NULL;
+    }
+
+    return msg;
+}
+
+
+SnapshotMessage* MessageView::as_snapshot() {
+
+    // frame is not a snapshot message
+    if (MESSAGE_SNAPSHOT != this->get_type()) {
+        return NULL;
+    }
+
+    SnapshotMessage* msg = reinterpret_cast<SnapshotMessage*>(this->frame);
+
+    // frame is missing some of its bitmap
+    if (msg->get_size() > this->size) {
+        return NULL;
+    }
+
+    return msg;
+}
+
+
+BeaconMessage* MessageView::as_beacon() {
+
+    // frame is not a complete beacon message
+    if (MESSAGE_BEACON != this->get_type() || sizeof(BeaconMessage) > this->size) {
+        return NULL;
+    }
+
+    return reinterpret_cast<BeaconMessage*>(this->frame);
+}
+
+
+StatsMessage* MessageView::as_stats() {
+
+    // frame is not a stats message
+    if (MESSAGE_STATS != this->get_type()) {
+        return NULL;
+    }
+
+    StatsMessage* msg = reinterpret_cast<StatsMessage*>(this->frame);
+
+    // frame is missing some of its counters
+    if (msg->get_size() > this->size) {
+        return NULL;
+    }
+
+    return msg;
+}
+
+
+TraceMessage* MessageView::as_trace() {
+
+    // frame is not a trace message
+    if (MESSAGE_TRACE != this->get_type()) {
+        return NULL;
+    }
+
+    TraceMessage* msg = reinterpret_cast<TraceMessage*>(this->frame);
+
+    // frame is missing some of its hops
+    if (msg->get_size() > this->size) {
+        return NULL;
+    }
+
+    return msg;
+}
+
+
+QueryMessage* MessageView::as_query() {
+
+    // frame is not a query message
+    if (MESSAGE_QUERY != this->get_type()) {
+        return NULL;
+    }
+
+    QueryMessage* msg = reinterpret_cast<QueryMessage*>(this->frame);
+
+    // frame is missing some of its bitmap
+    if (msg->get_size() > this->size) {
+        return NULL;
+    }
+
+    return msg;
+}
+
+
+ConfigMessage* MessageView::as_config() {
+
+    // frame is not a complete config message
+    if (MESSAGE_CONFIG != this->get_type() || sizeof(ConfigMessage) > this->size) {
+        return NULL;
+    }
+
+    return reinterpret_cast<ConfigMessage*>(this->frame);
+}
+
+
+bool dispatch_message(MessageView* msg, const message_handler_t* handlers, uint8_t num_handlers) {
+
+    uint8_t type = msg->get_type();
+
+    for (uint8_t i = 0; i < num_handlers; i++) {
+
+        if (type == handlers[i].msg_type) {
+            handlers[i].handle(msg);
+            return true;
+        }
+    }
+
+    return false;
+}
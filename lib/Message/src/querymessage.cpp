@@ -0,0 +1,82 @@
+/**
+* @brief: Contains the implementation of the QueryMessage class.
+* @file: querymessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "bitmap.hpp"
+#include "querymessage.hpp"
+
+
+QueryMessage::QueryMessage() : Message() {
+
+    this->first_node_id = 0;
+    this->num_nodes = 0;
+    memset(this->target_bitmap, 0, sizeof(this->target_bitmap));
+}
+
+
+QueryMessage::QueryMessage(uint8_t rx_id,
+                           uint8_t tx_id,
+                           uint8_t first_node_id,
+                           uint8_t num_nodes) : Message(rx_id, tx_id, MESSAGE_QUERY) {
+
+    this->first_node_id = first_node_id;
+    this->num_nodes = min(num_nodes, (uint8_t)QUERY_MAX_NODES);
+    memset(this->target_bitmap, 0, sizeof(this->target_bitmap));
+}
+
+
+uint8_t QueryMessage::get_first_node_id() {
+
+    return this->first_node_id;
+}
+
+
+uint8_t QueryMessage::get_num_nodes() {
+
+    // guard against a corrupted node count
+    return min(this->num_nodes, (uint8_t)QUERY_MAX_NODES);
+}
+
+
+bool QueryMessage::set_is_queried(uint8_t node_id, bool is_queried) {
+
+    // node is not covered by the query
+    if (node_id < this->first_node_id || (node_id - this->first_node_id) >= this->get_num_nodes()) {
+        return false;
+    }
+
+    bitmap_set(this->target_bitmap, node_id - this->first_node_id, is_queried);
+
+    return true;
+}
+
+
+bool QueryMessage::get_is_queried(uint8_t node_id) {
+
+    // node is not covered by the query
+    if (node_id < this->first_node_id || (node_id - this->first_node_id) >= this->get_num_nodes()) {
+        return false;
+    }
+
+    return bitmap_get(this->target_bitmap, node_id - this->first_node_id);
+}
+
+
+bool QueryMessage::is_empty() {
+
+    return 0 == bitmap_count(this->target_bitmap, this->get_num_nodes());
+}
+
+
+uint8_t QueryMessage::get_size() {
+
+    return sizeof(*this) - sizeof(this->target_bitmap) + BITMAP_SIZE(this->get_num_nodes());
+}
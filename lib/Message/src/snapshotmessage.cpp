@@ -0,0 +1,105 @@
+/**
+* @brief: Contains the implementation of the SnapshotMessage class.
+* @file: snapshotmessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "bitmap.hpp"
+#include "snapshotmessage.hpp"
+
+
+SnapshotMessage::SnapshotMessage() : Message() {
+
+    this->sequence = 0;
+    this->first_node_id = 0;
+    this->num_nodes = 0;
+    memset(this->status_bitmap, 0, sizeof(this->status_bitmap));
+}
+
+
+SnapshotMessage::SnapshotMessage(uint8_t rx_id,
+                                 uint8_t tx_id,
+                                 uint8_t sequence,
+                                 uint8_t first_node_id,
+                                 uint8_t num_nodes) : Message(rx_id, tx_id, MESSAGE_SNAPSHOT) {
+
+    this->sequence = sequence;
+    this->first_node_id = first_node_id;
+    this->num_nodes = min(num_nodes, (uint8_t)SNAPSHOT_MAX_NODES);
+    memset(this->status_bitmap, 0, sizeof(this->status_bitmap));
+}
+
+
+uint8_t SnapshotMessage::get_sequence() {
+
+    return this->sequence;
+}
+
+
+uint8_t SnapshotMessage::get_first_node_id() {
+
+    return this->first_node_id;
+}
+
+
+uint8_t SnapshotMessage::get_num_nodes() {
+
+    // guard against a corrupted node count
+    return min(this->num_nodes, (uint8_t)SNAPSHOT_MAX_NODES);
+}
+
+
+bool SnapshotMessage::is_in_snapshot(uint8_t node_id) {
+
+    return node_id >= this->first_node_id
+        && (node_id - this->first_node_id) < this->get_num_nodes();
+}
+
+
+bool SnapshotMessage::has_status(uint8_t node_id) {
+
+    // node is not covered by the snapshot
+    if (false == this->is_in_snapshot(node_id)) {
+        return false;
+    }
+
+    return bitmap_get(this->status_bitmap, 2 * (node_id - this->first_node_id));
+}
+
+
+bool SnapshotMessage::set_is_vacant(uint8_t node_id, bool is_vacant) {
+
+    // node is not covered by the snapshot
+    if (false == this->is_in_snapshot(node_id)) {
+        return false;
+    }
+
+    uint16_t bit = 2 * (node_id - this->first_node_id);
+    bitmap_set(this->status_bitmap, bit, true);
+    bitmap_set(this->status_bitmap, bit + 1, is_vacant);
+
+    return true;
+}
+
+
+bool SnapshotMessage::get_is_vacant(uint8_t node_id) {
+
+    // node has no status in the snapshot
+    if (false == this->has_status(node_id)) {
+        return false;
+    }
+
+    return bitmap_get(this->status_bitmap, (2 * (node_id - this->first_node_id)) + 1);
+}
+
+
+uint8_t SnapshotMessage::get_size() {
+
+    return sizeof(*this) - sizeof(this->status_bitmap) + BITMAP_SIZE(2 * this->get_num_nodes());
+}
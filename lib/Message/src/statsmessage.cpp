@@ -0,0 +1,66 @@
+/**
+* @brief: Contains the implementation of the StatsMessage class.
+* @file: statsmessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "statsmessage.hpp"
+
+
+StatsMessage::StatsMessage() : Message() {}
+
+
+StatsMessage::StatsMessage(uint8_t rx_id,
+                           uint8_t tx_id,
+                           uint8_t node_id,
+                           const uint16_t* counters,
+                           uint8_t num_counters) : Message(rx_id, tx_id, MESSAGE_STATS) {
+
+    this->node_id = node_id;
+    this->num_counters = min(num_counters, (uint8_t)STATS_MAX_COUNTERS);
+
+    for (uint8_t i = 0; i < this->num_counters; i++) {
+        this->counters[2 * i] = counters[i] & 0xFF;
+        this->counters[(2 * i) + 1] = counters[i] >> 8;
+    }
+}
+
+
+uint8_t StatsMessage::get_node_id() {
+
+    return this->node_id;
+}
+
+
+uint8_t StatsMessage::get_num_counters() {
+
+    // guard against a corrupted counter count
+    if (STATS_MAX_COUNTERS < this->num_counters) {
+        return STATS_MAX_COUNTERS;
+    }
+
+    return this->num_counters;
+}
+
+
+uint16_t StatsMessage::get_counter(uint8_t index) {
+
+    // counter is not in the message
+    if (this->get_num_counters() <= index) {
+        return 0;
+    }
+
+    return this->counters[2 * index] | ((uint16_t)this->counters[(2 * index) + 1] << 8);
+}
+
+
+uint8_t StatsMessage::get_size() {
+
+    return sizeof(*this) - sizeof(this->counters) + (2 * this->get_num_counters());
+}
@@ -0,0 +1,85 @@
+/**
+* @brief: Contains the implementation of the TraceMessage class.
+* @file: tracemessage.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "message.hpp"
+#include "tracemessage.hpp"
+
+
+TraceMessage::TraceMessage() : Message() {}
+
+
+TraceMessage::TraceMessage(uint8_t rx_id,
+                           uint8_t tx_id,
+                           uint8_t origin_id,
+                           uint8_t sequence) : Message(rx_id, tx_id, MESSAGE_TRACE) {
+
+    this->origin_id = origin_id;
+    this->sequence = sequence;
+}
+
+
+bool TraceMessage::add_hop(uint8_t node_id, uint32_t delay_ms) {
+
+    // no room for another hop
+    if (TRACE_MAX_HOPS <= this->get_num_hops()) {
+        return false;
+    }
+
+    uint16_t delay = (UINT16_MAX < delay_ms) ? UINT16_MAX : (uint16_t)delay_ms;
+
+    this->hops[this->num_hops].node_id = node_id;
+    this->hops[this->num_hops].delay_lo = delay & 0xFF;
+    this->hops[this->num_hops].delay_hi = delay >> 8;
+    this->num_hops++;
+
+    return true;
+}
+
+
+uint8_t TraceMessage::get_origin_id() {
+
+    return this->origin_id;
+}
+
+
+uint8_t TraceMessage::get_sequence() {
+
+    return this->sequence;
+}
+
+
+uint8_t TraceMessage::get_num_hops() {
+
+    // guard against a corrupted hop count
+    if (TRACE_MAX_HOPS < this->num_hops) {
+        return TRACE_MAX_HOPS;
+    }
+
+    return this->num_hops;
+}
+
+
+uint8_t TraceMessage::get_hop_node_id(uint8_t index) {
+
+    return this->hops[index].node_id;
+}
+
+
+uint16_t TraceMessage::get_hop_delay_ms(uint8_t index) {
+
+    return this->hops[index].delay_lo | ((uint16_t)this->hops[index].delay_hi << 8);
+}
+
+
+uint8_t TraceMessage::get_size() {
+
+    return sizeof(*this) - sizeof(this->hops) + (this->get_num_hops() * sizeof(trace_hop_t));
+}
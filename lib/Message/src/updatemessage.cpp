@@ -17,16 +17,19 @@ UpdateMessage::UpdateMessage() : Message() {
 
     this->node_id = 0;
     this->is_vacant = false;
+    this->sequence = 0;
 }
 
 
 UpdateMessage::UpdateMessage(uint8_t rx_id,
                              uint8_t tx_id,
                              uint8_t node_id,
-                             bool is_vacant) : Message(rx_id, tx_id, MESSAGE_UPDATE) {
+                             bool is_vacant,
+                             uint8_t sequence) : Message(rx_id, tx_id, MESSAGE_UPDATE) {
 
     this->node_id = node_id;
     this->is_vacant = is_vacant;
+    this->sequence = sequence;
 }
 
 
@@ -40,3 +43,9 @@ bool UpdateMessage::get_is_vacant() {
 
     return this->is_vacant;
 }
+
+
+uint8_t UpdateMessage::get_sequence() {
+
+    return this->sequence;
+}
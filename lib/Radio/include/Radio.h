@@ -0,0 +1,14 @@
+/**
+* @brief: Includes all required headers for the Radio library
+* @file: Radio.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _RADIO_H_
+#define _RADIO_H_
+
+#include "radioconfig.hpp"
+#include "radionode.hpp"
+
+#endif // _RADIO_H_
@@ -0,0 +1,109 @@
+/**
+* @brief: Contains the radio settings shared by every node of the network
+* @file: radioconfig.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _RADIO_CONFIG_HPP_
+#define _RADIO_CONFIG_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// local libraries
+#include <Layout.h>
+
+
+// Settings in this file must match on every node and the base station, so
+// they live in the one library both firmwares are built from.
+
+// base station's node ID
+#define BASE_STATION_ID LAYOUT_BASE_STATION_ID
+
+// special base station address since 0x00000000 is not a valid address
+#define BASE_STATION_ADDRESS 0xBAD1DEA5
+
+// width in bytes of the radio's address
+#define RF24_ADDRESS_WIDTH 4
+
+#define RF24_CHANNEL_SPACING 5  // number of channels between a valid node channel
+#define RF24_MAX_CHANNEL 125    // highest channel of the NRF24L01
+#define RF24_BROADCAST_PIPE 0   // reading pipe for broadcast messages
+#define RF24_READING_PIPE 1     // reading pipe for the NRF24L01
+#define RF24_NEIGHBOR_PIPE 2    // first of the reading pipes given to neighbors
+
+// changes the least significant address byte of each neighbor's pipe, which
+// is the only byte that can differ from the node's reading pipe
+#define RF24_NEIGHBOR_PIPE_XOR 0x81
+
+#define MAX_SEND_ATTEMPTS 15    // default maximum number of attempts to send a message
+#define FAILED_SEND_DELAY 15    // default minimum delay between sending message attempts
+
+#define CONFIG_RETRY_MS 2000    // time between passing a config again to next nodes that did not acknowledge it
+#define CONFIG_MAX_ATTEMPTS 5   // times a config is passed on before its radio settings are given up
+
+// time a switch to new radio settings has to get a message through before a
+// failed transmission reverts to the previous settings. Nodes switch once
+// their next nodes have a config, so the nodes farthest from the sink switch
+// first. A node whose nodes toward the sink then never switch, because an
+// acknowledgement on their way was lost for every attempt, is cut off until
+// this fallback.
+#define CONFIG_FALLBACK_MS 60000
+
+// give every neighbor on the routing grid its own reading pipe, so the sender
+// of a message is known from the pipe it arrived on (0 to disable)
+#define RF24_NEIGHBOR_PIPES_ENABLED 1
+
+// Nodes share a channel per cluster of RF24_CLUSTER_SIZE consecutive node IDs
+// and are told apart by address, instead of each node having its own channel
+// (0 to disable)
+#define RF24_SHARED_CHANNEL_ENABLED 0
+#define RF24_CLUSTER_SIZE 255
+
+// every node ID or cluster of them needs a channel of its own
+#if RF24_SHARED_CHANNEL_ENABLED
+static_assert(RF24_MAX_CHANNEL >= (LAYOUT_MAX_NODE_ID / RF24_CLUSTER_SIZE) * RF24_CHANNEL_SPACING,
+              "too many clusters for the radio's channels, increase RF24_CLUSTER_SIZE");
+#else
+static_assert(RF24_MAX_CHANNEL >= LAYOUT_MAX_NODE_ID * RF24_CHANNEL_SPACING,
+              "too many node IDs for a channel each, enable RF24_SHARED_CHANNEL_ENABLED");
+#endif
+
+// transmit in TDMA slots synchronized by base station beacons instead of
+// carrier sense with random back-off (0 to disable). Requires a shared channel.
+#define TDMA_ENABLED 0
+
+#if TDMA_ENABLED && !RF24_SHARED_CHANNEL_ENABLED
+#error "TDMA requires RF24_SHARED_CHANNEL_ENABLED"
+#endif
+
+
+// part a node plays in the network
+enum radio_role_t {
+    ROLE_SENSOR = 0,    // reports its own parking stall and forwards for others
+    ROLE_SINK = 1       // collects the statuses of its region
+};
+
+
+/**
+ * @brief Hardware settings of a node's radio
+ * 
+ * @tparam CE: NRF24L01 CE pin assignment
+ * @tparam CSN: NRF24L01 CSN pin assignment
+ * @tparam IRQ: NRF24L01 IRQ pin assignment (must support external interrupts)
+ * @tparam IS_IRQ_DRIVEN: receive messages from the radio's IRQ instead of polling
+ * @tparam QUEUE_SIZE: number of slots for buffering received messages in RAM
+ *      when IRQ driven (power of two)
+ */
+template <uint8_t CE, uint8_t CSN, uint8_t IRQ, bool IS_IRQ_DRIVEN, uint8_t QUEUE_SIZE>
+struct RadioConfig {
+    static constexpr uint8_t ce_pin = CE;
+    static constexpr uint8_t csn_pin = CSN;
+    static constexpr uint8_t irq_pin = IRQ;
+    static constexpr bool is_irq_driven = IS_IRQ_DRIVEN;
+    static constexpr uint8_t rx_queue_size = QUEUE_SIZE;
+};
+
+
+#endif // _RADIO_CONFIG_HPP_
@@ -0,0 +1,740 @@
+/**
+* @brief: Contains the RadioNode class template.
+* @file: radionode.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _RADIO_NODE_HPP_
+#define _RADIO_NODE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <EEPROM.h>
+#include <nRF24L01.h>
+#include <RF24.h>
+
+// local libraries
+#include <Counters.h>
+#include <Layout.h>
+#include <Message.h>
+
+// local dependencies
+#include "radioconfig.hpp"
+
+
+/**
+ * @brief Buffers of received messages for a radio read from its IRQ
+ * 
+ * @tparam IS_IRQ_DRIVEN: if messages are received from the radio's IRQ
+ * @tparam QUEUE_SIZE: number of slots for buffering received messages
+ */
+template <bool IS_IRQ_DRIVEN, uint8_t QUEUE_SIZE>
+struct RadioReceiver {
+
+    // messages drained from the radio waiting to be read
+    FrameQueue<QUEUE_SIZE> queue;
+
+    // radio is being accessed outside of the interrupt
+    volatile bool is_radio_busy = false;
+
+    // interrupt occurred while the radio was being accessed
+    volatile bool is_irq_pending = false;
+};
+
+
+/**
+ * @brief Buffer of the most recent message for a polled radio
+ */
+template <uint8_t QUEUE_SIZE>
+struct RadioReceiver<false, QUEUE_SIZE> {
+
+    // most recently received message and the reading pipe it arrived on
+    uint8_t frame[MESSAGE_MAX_SIZE];
+    uint8_t pipe = 0;
+};
+
+
+// config stored in EEPROM
+struct MESSAGE_PACKED config_record_t {
+    ConfigMessage config;   // most recently applied config message
+    uint8_t crc;            // CRC-8 of everything before
+};
+
+
+/**
+ * @brief Radio addressing and reception shared by every node of the network
+ * 
+ * Sensor nodes and sinks derive from it. Both template parameters are known at
+ * compile time, so code for other roles and the unused receive path is never
+ * built and only the buffers of the chosen receive path take up RAM.
+ * 
+ * @tparam ROLE: part the node plays in the network
+ * @tparam CONFIG: hardware settings of the radio (a RadioConfig)
+ */
+template <radio_role_t ROLE, typename CONFIG>
+class RadioNode {
+
+    protected:
+
+        // unique id of the node
+        uint8_t node_id = 0;
+
+        // NRF24L01 transciever radio
+        RF24 radio = RF24(CONFIG::ce_pin, CONFIG::csn_pin);
+        uint32_t radio_address = 0;
+        uint8_t radio_channel = 0;
+
+        // received messages waiting to be read
+        RadioReceiver<CONFIG::is_irq_driven, CONFIG::rx_queue_size> receiver;
+
+        // node servicing the radio's interrupt
+        static RadioNode* irq_node;
+
+        // radio settings that can be changed over the air
+        uint8_t max_send_attempts = MAX_SEND_ATTEMPTS;
+        uint8_t failed_send_delay = FAILED_SEND_DELAY;
+        uint8_t max_pa_level = RF24_PA_MAX;
+        uint8_t data_rate = RF24_1MBPS;
+
+        // version of the config the node runs
+        uint8_t config_version = CONFIG_VERSION_NONE;
+
+        // radio settings and config version in place before the last switch,
+        // kept until a message gets through on the new settings
+        config_settings_t fallback_settings = {};
+        uint8_t fallback_version = CONFIG_VERSION_NONE;
+        uint32_t switch_ms = 0;
+        bool is_switch_confirmed = true;
+
+        /**
+         * @brief Constructs a RadioNode object
+         * 
+         * @param node_id: unique id of the node
+         */
+        RadioNode(uint8_t node_id) {
+
+            this->node_id = node_id;
+
+            this->radio_address = RadioNode::calculate_radio_address(node_id);
+            this->radio_channel = RadioNode::calculate_radio_channel(node_id);
+        }
+
+        /**
+         * @brief Starts and configures the radio and starts listening
+         * 
+         * @return True on success. Otherwise false
+         */
+        bool init_radio() {
+
+            // start radio
+            if (false == this->radio.begin()) {
+                return false;
+            }
+
+            // configure radio
+            this->radio.enableDynamicPayloads();
+            this->radio.setAutoAck(true);
+            this->radio.setRetries(this->failed_send_delay, this->max_send_attempts);
+            this->radio.setAddressWidth(RF24_ADDRESS_WIDTH);
+            this->radio.setPALevel(this->max_pa_level);
+            (void) this->radio.setDataRate((rf24_datarate_e)this->data_rate);
+            this->radio.setChannel(this->radio_channel);
+            this->open_reading_pipes();
+
+#if TDMA_ENABLED
+            // beacons are sent without acknowledgement
+            this->radio.enableDynamicAck();
+
+            // sinks send beacons and every other node listens for them
+            if (ROLE_SINK != ROLE) {
+                this->radio.openReadingPipe(RF24_BROADCAST_PIPE, BROADCAST_ADDRESS);
+            }
+#endif
+
+            // start listening on radio
+            this->radio.startListening();
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+
+                // only interrupt when a message is received
+                this->radio.maskIRQ(true, true, false);
+
+                RadioNode::irq_node = this;
+                pinMode(CONFIG::irq_pin, INPUT);
+                attachInterrupt(digitalPinToInterrupt(CONFIG::irq_pin), RadioNode::on_radio_irq, FALLING);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Takes the radio settings of a config without applying them to the radio
+         * 
+         * Settings that are CONFIG_KEEP or out of range keep their current value.
+         * 
+         * @param settings: settings to take
+         */
+        void set_radio_settings(config_settings_t settings) {
+
+            if (15 >= settings.max_send_attempts) {
+                this->max_send_attempts = settings.max_send_attempts;
+            }
+
+            if (15 >= settings.failed_send_delay) {
+                this->failed_send_delay = settings.failed_send_delay;
+            }
+
+            if (RF24_PA_MAX >= settings.pa_level) {
+                this->max_pa_level = settings.pa_level;
+            }
+
+            if (RF24_250KBPS >= settings.data_rate) {
+                this->data_rate = settings.data_rate;
+            }
+        }
+
+        /**
+         * @brief Applies the radio settings to the running radio
+         */
+        void apply_radio_settings() {
+
+            this->begin_radio_access();
+
+            this->radio.setRetries(this->failed_send_delay, this->max_send_attempts);
+            this->radio.setPALevel(this->max_pa_level);
+            (void) this->radio.setDataRate((rf24_datarate_e)this->data_rate);
+
+            this->end_radio_access();
+        }
+
+        /**
+         * @brief Applies the radio settings of a config to the running radio without taking them
+         * 
+         * Lets a node reach neighbors that already switched to the settings.
+         * apply_radio_settings() puts the node's own settings back.
+         * 
+         * @param settings: settings to apply
+         * @return True if the PA level or data rate changed. Otherwise false
+         */
+        bool try_radio_settings(config_settings_t settings) {
+
+            uint8_t pa_level = (RF24_PA_MAX >= settings.pa_level) ? settings.pa_level : this->max_pa_level;
+            uint8_t data_rate = (RF24_250KBPS >= settings.data_rate) ? settings.data_rate : this->data_rate;
+
+            if (pa_level == this->max_pa_level && data_rate == this->data_rate) {
+                return false;
+            }
+
+            this->begin_radio_access();
+
+            this->radio.setPALevel(pa_level);
+            (void) this->radio.setDataRate((rf24_datarate_e)data_rate);
+
+            this->end_radio_access();
+
+            return true;
+        }
+
+        /**
+         * @brief Switches the running radio to the radio settings of a config
+         * 
+         * The previous settings are kept, so they can be restored if the new
+         * ones do not get a message through.
+         * 
+         * @param settings: settings to switch to
+         * @param version: version of the config the settings are from
+         */
+        void switch_radio_settings(config_settings_t settings, uint8_t version) {
+
+            memset(&this->fallback_settings, CONFIG_KEEP, sizeof(this->fallback_settings));
+            this->fallback_settings.max_send_attempts = this->max_send_attempts;
+            this->fallback_settings.failed_send_delay = this->failed_send_delay;
+            this->fallback_settings.pa_level = this->max_pa_level;
+            this->fallback_settings.data_rate = this->data_rate;
+            this->fallback_version = this->config_version;
+
+            this->config_version = version;
+            this->set_radio_settings(settings);
+            this->apply_radio_settings();
+
+            // only a new power level or data rate can cut the node off
+            if (this->fallback_settings.pa_level != this->max_pa_level
+                || this->fallback_settings.data_rate != this->data_rate) {
+
+                this->switch_ms = millis();
+                this->is_switch_confirmed = false;
+            }
+        }
+
+        /**
+         * @brief Records that a message got through on the current radio settings
+         */
+        void confirm_radio_settings() {
+
+            this->is_switch_confirmed = true;
+        }
+
+        /**
+         * @brief Determines if the radio settings should be reverted after a failed transmission
+         * 
+         * @return True if the last switch got no message through for
+         *      CONFIG_FALLBACK_MS. Otherwise false
+         */
+        bool is_radio_fallback_due() {
+
+            return false == this->is_switch_confirmed && CONFIG_FALLBACK_MS <= (millis() - this->switch_ms);
+        }
+
+        /**
+         * @brief Reverts the running radio to the settings before the last switch
+         * 
+         * The config version is reverted too, so the config can be sent again.
+         */
+        void fall_back_radio_settings() {
+
+            this->config_version = this->fallback_version;
+            this->set_radio_settings(this->fallback_settings);
+            this->apply_radio_settings();
+
+            this->is_switch_confirmed = true;
+        }
+
+        /**
+         * @brief Loads the most recently applied config from EEPROM
+         * 
+         * @param address: EEPROM address of the config record
+         * @param config: loaded config
+         * @return True if a valid config was found. Otherwise false
+         */
+        static bool load_config(int address, ConfigMessage* config) {
+
+            config_record_t record;
+            EEPROM.get(address, record);
+
+            // record was never written or the write was interrupted
+            if (record.crc != frame_crc((uint8_t*)&record, sizeof(record) - 1)
+                || MESSAGE_CONFIG != record.config.get_type()) {
+
+                return false;
+            }
+
+            *config = record.config;
+
+            return true;
+        }
+
+        /**
+         * @brief Stores a config in EEPROM so it is applied after a restart
+         * 
+         * Only bytes that changed are written.
+         * 
+         * @param address: EEPROM address of the config record
+         * @param config: config to store
+         */
+        static void store_config(int address, ConfigMessage* config) {
+
+            config_record_t record;
+            record.config = *config;
+            record.crc = frame_crc((uint8_t*)&record, sizeof(record) - 1);
+
+            EEPROM.put(address, record);
+        }
+
+        /**
+         * @brief Calculates a given node's radio address based on the node ID
+         * 
+         * @param node_id: ID of node to calculate address for
+         * @return The calculated radio address for the node
+         */
+        static constexpr uint32_t calculate_radio_address(uint8_t node_id) {
+
+            // base station has special non-calculated address
+            if (BASE_STATION_ID == node_id) {
+                return BASE_STATION_ADDRESS;
+            }
+
+            // every address byte is the node ID
+            return node_id * (uint32_t)0x01010101;
+        }
+
+        /**
+         * @brief Calculates the address of a node's reading pipe for a neighbor
+         * 
+         * @param node_id: ID of node to calculate address for
+         * @param index: index of the neighbor (0 to LAYOUT_NUM_NEIGHBORS - 1)
+         * @return The calculated radio address of the pipe
+         */
+        static constexpr uint32_t calculate_pipe_address(uint8_t node_id, uint8_t index) {
+
+            uint32_t address = RadioNode::calculate_radio_address(node_id);
+
+            return (address & 0xFFFFFF00) | ((address ^ (RF24_NEIGHBOR_PIPE_XOR + index)) & 0xFF);
+        }
+
+        /**
+         * @brief Calculates a given node's radio channel based on the node ID
+         * 
+         * @param node_id: ID of node to calculate channel for
+         * @return The calculated radio channel for the node (0-125)
+         */
+        static constexpr uint8_t calculate_radio_channel(uint8_t node_id) {
+
+#if RF24_SHARED_CHANNEL_ENABLED
+            // every node in a cluster shares a channel
+            return (node_id / RF24_CLUSTER_SIZE) * RF24_CHANNEL_SPACING;
+#else
+            return node_id * RF24_CHANNEL_SPACING;
+#endif
+        }
+
+        /**
+         * @brief Calculates the address this node transmits to a given node on
+         * 
+         * Neighbors use their own reading pipe of the node, every other node
+         * uses the node's radio address.
+         * 
+         * @param rx_node_id: ID of receiving node
+         * @return The calculated radio address
+         */
+        uint32_t calculate_tx_address(uint8_t rx_node_id) {
+
+#if RF24_NEIGHBOR_PIPES_ENABLED
+            // neighbors have their own pipe
+            uint8_t index = layout_read_neighbor_index(rx_node_id, this->node_id);
+
+            if (LAYOUT_NONE != index) {
+                return RadioNode::calculate_pipe_address(rx_node_id, index);
+            }
+#endif
+
+            return RadioNode::calculate_radio_address(rx_node_id);
+        }
+
+        /**
+         * @brief Opens the node's reading pipes on its own channel
+         */
+        void open_reading_pipes() {
+
+            this->radio.openReadingPipe(RF24_READING_PIPE, this->radio_address);
+
+#if RF24_NEIGHBOR_PIPES_ENABLED
+            // neighbor pipes take all but their last address byte from the one above
+            for (uint8_t i = 0; i < LAYOUT_NUM_NEIGHBORS; i++) {
+
+                if (LAYOUT_NONE != layout_read_neighbor(this->node_id, i)) {
+                    this->radio.openReadingPipe(RF24_NEIGHBOR_PIPE + i, RadioNode::calculate_pipe_address(this->node_id, i));
+                }
+            }
+#endif
+        }
+
+        /**
+         * @brief Closes the node's reading pipes before leaving its channel
+         */
+        void close_reading_pipes() {
+
+            this->radio.closeReadingPipe(RF24_READING_PIPE);
+
+#if RF24_NEIGHBOR_PIPES_ENABLED
+            for (uint8_t i = 0; i < LAYOUT_NUM_NEIGHBORS; i++) {
+                this->radio.closeReadingPipe(RF24_NEIGHBOR_PIPE + i);
+            }
+#endif
+        }
+
+        /**
+         * @brief Handles the radio's interrupt
+         */
+        static void on_radio_irq() {
+
+            RadioNode* node = RadioNode::irq_node;
+
+            // radio is not initialized
+            if (NULL == node) {
+                return;
+            }
+
+            // radio is in use so defer draining until it is released
+            if (true == node->receiver.is_radio_busy) {
+                node->receiver.is_irq_pending = true;
+                return;
+            }
+
+            node->drain_radio();
+        }
+
+        /**
+         * @brief Moves all messages from the radio's FIFO into the receive queue
+         */
+        void drain_radio() {
+
+            // clear the interrupt flags
+            bool tx_ok, tx_fail, rx_ready;
+            this->radio.whatHappened(tx_ok, tx_fail, rx_ready);
+
+            uint8_t pipe = 0;
+
+            while (true == this->radio.available(&pipe)) {
+
+                uint8_t* slot = this->receiver.queue.reserve();
+
+                // queue is full so leave remaining messages in the radio's FIFO
+                if (NULL == slot) {
+                    COUNTER_INC(COUNTER_RX_OVERFLOWS);
+                    break;
+                }
+
+                uint8_t size = this->radio.getDynamicPayloadSize();
+                size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+
+                // read directly into the queue
+                memset(slot, 0, MESSAGE_MAX_SIZE);
+                this->radio.read(slot, size);
+
+                this->receiver.queue.commit(size, pipe);
+                COUNTER_INC(COUNTER_RX_FRAMES);
+            }
+        }
+
+        /**
+         * @brief Marks the radio as in use outside of the interrupt
+         * 
+         * Does nothing for a polled radio.
+         */
+        void begin_radio_access() {
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+                this->receiver.is_radio_busy = true;
+            }
+        }
+
+        /**
+         * @brief Releases the radio and services any interrupt that occurred
+         * 
+         * Does nothing for a polled radio.
+         */
+        void end_radio_access() {
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+
+                // service any interrupts that occurred while the radio was in use
+                this->receiver.is_irq_pending = false;
+                this->drain_radio();
+
+                this->receiver.is_radio_busy = false;
+
+                // service an interrupt that occurred while draining
+                if (true == this->receiver.is_irq_pending) {
+                    this->receiver.is_irq_pending = false;
+                    this->drain_radio();
+                }
+            }
+        }
+
+
+    public:
+
+        /**
+         * @brief Determine if there is a message available to read
+         * 
+         * @return True if a message is available. Otherwise false
+         */
+        bool is_message() {
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+                return false == this->receiver.queue.is_empty();
+            }
+            else {
+                return this->radio.available();
+            }
+        }
+
+        /**
+         * @brief Gets a message from the message queue
+         * 
+         * @param buffer: buffer to hold message
+         * @param len: size of buffer
+         * @return True if a message was read. Otherwise false
+         */
+        bool read_message(uint8_t** buffer, uint8_t len) {
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+
+                if (false == this->receiver.queue.pop(buffer, len)) {
+                    return false;
+                }
+
+                // pull in messages left in the radio's FIFO now that there is room
+                this->begin_radio_access();
+                this->end_radio_access();
+            }
+            else {
+
+                if (false == this->radio.available()) {
+                    return false;
+                }
+
+                this->radio.read(buffer, len);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Gets a view of the oldest received message without copying it
+         * 
+         * The view remains valid until release_message() is called.
+         * 
+         * @param msg: view to refer to the message
+         * @return True if a message was available. Otherwise false
+         */
+        bool receive_message(MessageView* msg) {
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+
+                const uint8_t* frame = this->receiver.queue.front();
+
+                if (NULL == frame) {
+                    return false;
+                }
+
+                *msg = MessageView((uint8_t*)frame, this->receiver.queue.front_size());
+            }
+            else {
+
+                if (false == this->radio.available(&this->receiver.pipe)) {
+                    return false;
+                }
+
+                uint8_t size = this->radio.getDynamicPayloadSize();
+                size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+
+                memset(this->receiver.frame, 0, sizeof(this->receiver.frame));
+                this->radio.read(this->receiver.frame, size);
+                COUNTER_INC(COUNTER_RX_FRAMES);
+
+                *msg = MessageView(this->receiver.frame, size);
+            }
+
+            // sinks only hear from nodes that run the same radio settings
+            if constexpr (ROLE_SINK == ROLE) {
+                this->confirm_radio_settings();
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Removes the message last returned by receive_message()
+         */
+        void release_message() {
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+
+                this->receiver.queue.pop();
+
+                // pull in messages left in the radio's FIFO now that there is room
+                this->begin_radio_access();
+                this->end_radio_access();
+            }
+        }
+
+        /**
+         * @brief Gets the sender of the message last returned by receive_message()
+         * 
+         * Known from the reading pipe the message arrived on without decoding it.
+         * 
+         * @return ID of the neighbor that sent it. Otherwise -1 if it arrived on a shared pipe
+         */
+        int16_t get_message_sender() {
+
+            uint8_t pipe = 0;
+
+            if constexpr (true == CONFIG::is_irq_driven) {
+                pipe = this->receiver.queue.front_pipe();
+            }
+            else {
+                pipe = this->receiver.pipe;
+            }
+
+#if RF24_NEIGHBOR_PIPES_ENABLED
+            // neighbor pipes identify the neighbor that sent the message
+            if (RF24_NEIGHBOR_PIPE <= pipe && (RF24_NEIGHBOR_PIPE + LAYOUT_NUM_NEIGHBORS) > pipe) {
+
+                uint8_t neighbor_id = layout_read_neighbor(this->node_id, pipe - RF24_NEIGHBOR_PIPE);
+
+                if (LAYOUT_NONE != neighbor_id) {
+                    return neighbor_id;
+                }
+            }
+#endif
+
+            (void) pipe;
+
+            return -1;
+        }
+
+        /**
+         * @brief Waits until a message is available or a timeout occurs
+         * 
+         * Sinks with an IRQ driven radio sleep between interrupts. Other roles
+         * poll, since sensor nodes manage sleep themselves.
+         * 
+         * @param timeout_ms: maximum time to wait in milliseconds
+         * @return True if a message is available. Otherwise false
+         */
+        bool wait_for_message(uint32_t timeout_ms) {
+
+            uint32_t start_ms = millis();
+
+            while (timeout_ms > (millis() - start_ms)) {
+
+                if constexpr (ROLE_SINK == ROLE && true == CONFIG::is_irq_driven) {
+
+                    // messages are only queued by the radio's interrupt, so check with
+                    // interrupts disabled to not miss one arriving just before sleeping
+                    noInterrupts();
+
+                    if (true == this->is_message()) {
+                        interrupts();
+                        return true;
+                    }
+
+                    // idle until the next interrupt (radio, timer or display), the
+                    // instruction after enabling interrupts always runs first
+                    set_sleep_mode(SLEEP_MODE_IDLE);
+                    sleep_enable();
+                    interrupts();
+                    sleep_cpu();
+                    sleep_disable();
+                }
+                else {
+
+                    if (true == this->is_message()) {
+                        return true;
+                    }
+                }
+            }
+
+            return this->is_message();
+        }
+
+        /**
+         * @brief Get the ID of the node
+         * 
+         * @return ID of the node
+         */
+        uint8_t get_id() {
+
+            return this->node_id;
+        }
+};
+
+
+template <radio_role_t ROLE, typename CONFIG>
+RadioNode<ROLE, CONFIG>* RadioNode<ROLE, CONFIG>::irq_node = NULL;
+
+
+#endif // _RADIO_NODE_HPP_
@@ -0,0 +1,29 @@
+/**
+* @brief: Contains the prototype functions for low power sleep.
+* @file: lowpower.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _LOW_POWER_HPP_
+#define _LOW_POWER_HPP_
+
+// standard libraries
+#include <Arduino.h>
+
+// shortest time in milliseconds the microcontroller can sleep for
+#define LOW_POWER_MIN_SLEEP_MS 16
+
+/**
+ * @brief Puts the microcontroller into power-down sleep
+ * 
+ * Sleeps in power-down mode using the watchdog timer to wake up. Since the
+ * timer behind millis() is stopped while sleeping, millis() is advanced by
+ * the time slept. Sleep ends early if an external interrupt occurs.
+ * 
+ * @param duration_ms: maximum time to sleep in milliseconds
+ * @return Time slept in milliseconds
+ */
+uint32_t low_power_sleep(uint32_t duration_ms);
+
+#endif // _LOW_POWER_HPP_
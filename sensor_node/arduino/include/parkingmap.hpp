@@ -11,12 +11,45 @@
 // standard libraries
 #include <Arduino.h>
 
+#define NOT_SPOT -1  // represent space not for 
+
+// number of candidate next hops per node
+#define NUM_NEXT_HOPS 2
+
+/**
+ * @brief Gets a candidate next node ID for forwarding an ingress message
+ * 
+ * Nodes with only one neighbor toward a sink return the same
+ * node ID for every candidate index. SensorNode::get_next_hop() chooses
+ * between the candidates by delivery history and fails over to the other.
+ * 
+ * @param node_id: ID of current node
+ * @param index: index of the candidate (0 to NUM_NEXT_HOPS - 1)
+ * @return Candidate next node ID on success. Otherwise -1
+ */
+int16_t get_ingress_node_candidate(uint8_t node_id, uint8_t index);
+
 /**
- * @brief Gets the next node ID for forwarding an ingress message
+ * @brief Gets the next node ID for forwarding an egress message
+ * 
+ * Egress messages follow the first candidate route of the destination in
+ * reverse, so every node is reached through exactly one path.
  * 
  * @param node_id: ID of current node
- * @return Next node ID on success. Otherwise -1
+ * @param dest_id: ID of destination node
+ * @return Next node ID if the destination is reached through the current node. Otherwise -1
+ */
+int16_t get_next_egress_node(uint8_t node_id, uint8_t dest_id);
+
+/**
+ * @brief Gets the TDMA transmit slot of a node
+ * 
+ * Nodes with the most hops to a sink get the earliest slots so an
+ * update can be forwarded by every hop within one superframe.
+ * 
+ * @param node_id: ID of node
+ * @return Slot index on success. Otherwise -1
  */
-int16_t get_next_ingress_node(uint8_t node_id);
+int16_t get_tdma_slot(uint8_t node_id);
 
 #endif // _PARKING_MAP_H_
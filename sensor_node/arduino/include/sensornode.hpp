@@ -17,13 +17,48 @@
 
 // local libraries
 #include <Message.h>
+#include <Radio.h>
+
+// local dependencies
+#include "parkingmap.hpp"
 
 
 #define RF24_CE_PIN 7   // NRF24L01 CE pin assignment
 #define RF24_CSN_PIN 8  // NRF24L01 CSN pin assignment
+#define RF24_IRQ_PIN 2  // NRF24L01 IRQ pin assignment (must support external interrupts)
+
+// receive messages from the radio's IRQ instead of polling (0 to disable). Can
+// be set with -D in build_flags.
+#ifndef RF24_IRQ_ENABLED
+#define RF24_IRQ_ENABLED 1
+#endif
+
+// number of slots for buffering received messages in RAM (power of two)
+#define RX_QUEUE_SIZE 8
+
+// number of origin nodes whose last forwarded sequence number is remembered
+#define SEQUENCE_CACHE_SIZE 8
+
+// duty-cycle the microcontroller, ToF sensor and radio to save battery (0 to disable)
+#define LOW_POWER_ENABLED 0
+
+// range with the ToF sensor's continuous mode instead of blocking reads (0 to disable)
+#define TOF_CONTINUOUS_ENABLED 1
+
+// follow each status change to the base station with a trace message that
+// every hop adds the time it held the status to (0 to disable)
+#define TRACE_ENABLED 0
+
+// tune the auto retransmit delay and count of each link from the retries its
+// acknowledged messages needed (0 to disable)
+#define LINK_TUNING_ENABLED 1
 
-// width in bytes of the radio's address
-#define RF24_ADDRESS_WIDTH 4 
+#if TDMA_ENABLED && LOW_POWER_ENABLED
+#error "TDMA and LOW_POWER_ENABLED cannot be combined"
+#endif
+
+// hardware settings of the sensor node's radio
+typedef RadioConfig<RF24_CE_PIN, RF24_CSN_PIN, RF24_IRQ_PIN, RF24_IRQ_ENABLED, RX_QUEUE_SIZE> sensor_radio_config_t;
 
 
 // different states of the ToF sensor
@@ -34,12 +69,28 @@ enum tof_sensor_status_t {
 };
 
 
-class SensorNode {
+// settings for classifying ToF sensor ranges as occupied or vacant
+struct classifier_config_t {
+    uint8_t occupied_mm;    // ranges at or below this distance are occupied
+    uint8_t vacant_mm;      // ranges at or above this distance are vacant
+    uint8_t num_agree;      // samples that must agree to change status (N)
+    uint8_t num_window;     // most recent samples considered (M, 1-8)
+};
+
+
+// delivery history of the link to a neighboring node
+struct link_t {
+    int16_t node_id;    // ID of neighboring node or -1 if unused
+    uint8_t quality;    // moving average of delivery success (0-255)
+    uint8_t pa_level;   // power amplifier level used to transmit on the link
+    uint8_t retries;    // moving average of retransmissions per delivered message (1/16 steps)
+    uint8_t retry_delay;    // auto retransmit delay used on the link (250 us steps)
+};
 
-    private:
 
-        // unique id of the sensor node
-        uint8_t node_id = 0;
+class SensorNode : public RadioNode<ROLE_SENSOR, sensor_radio_config_t> {
+
+    private:
 
         // most recently read status of the sensor
         tof_sensor_status_t sensor_status = NOT_INITIALIZED;
@@ -47,26 +98,239 @@ class SensorNode {
         // VL6180X ToF sensor
         Adafruit_VL6180X sensor = Adafruit_VL6180X();
 
-        // NRF24L01 transciever radio
-        RF24 radio = RF24(RF24_CE_PIN, RF24_CSN_PIN);
-        uint32_t radio_address = 0;
-        uint8_t radio_channel = 0;
+        // settings for classifying ToF sensor ranges
+        classifier_config_t classifier;
+
+        // most recent classified samples with one bit per sample (1 = occupied)
+        uint8_t sample_history = 0;
+
+        // number of valid samples in the history
+        uint8_t num_samples = 0;
+
+        /**
+         * @brief Classifies a ToF sensor range and records it in the sample history
+         * 
+         * Ranges between the occupied and vacant thresholds keep the current
+         * status to provide hysteresis.
+         * 
+         * @param range_mm: range read from sensor in millimeters
+         * @param status: range status read from sensor
+         * @return True if a sample was recorded. Otherwise false
+         */
+        bool record_sample(uint8_t range_mm, uint8_t status);
+
+#if TDMA_ENABLED
+        // transmit slot of the node or -1 if it has none
+        int16_t tdma_slot = -1;
+
+        // most recent beacon received from the base station
+        BeaconMessage beacon = BeaconMessage();
+        bool is_beacon_received = false;
+
+        // time in milliseconds the most recent beacon was received
+        uint32_t beacon_ms = 0;
+
+        // time in milliseconds the current superframe started
+        uint32_t superframe_start_ms = 0;
+
+        /**
+         * @brief Gets the time since the start of the current superframe
+         * 
+         * @return Time in milliseconds
+         */
+        uint32_t get_superframe_offset_ms();
+#endif
+
+        /**
+         * @brief Transmit a message to every node in range without acknowledgement
+         * 
+         * @param msg: Message to be transmitted
+         * @param size: Number of bytes of the message to transmit
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_broadcast(Message* msg, uint8_t size);
+
+#if LOW_POWER_ENABLED
+        // time in milliseconds the ToF sensor was last sampled
+        uint32_t last_sample_ms = 0;
+
+        // time in milliseconds the current radio listen cycle started
+        uint32_t listen_cycle_ms = 0;
+
+        // radio is powered up
+        bool is_radio_on = true;
+
+        /**
+         * @brief Sleeps the microcontroller until woken or a timeout occurs
+         * 
+         * @param duration_ms: maximum time to sleep in milliseconds
+         * @param is_radio_wake: if a received message should end the sleep
+         */
+        void sleep(uint32_t duration_ms, bool is_radio_wake);
+#endif
+
+        // updates from other nodes waiting to be forwarded together
+        AggregateMessage pending_updates = AggregateMessage();
+
+        // time in milliseconds the oldest pending update was queued
+        uint32_t pending_updates_ms = 0;
+
+        // sequence number of the node's next status
+        uint8_t status_sequence = SEQUENCE_RESTART;
+
+        // last sequence number forwarded for other nodes' statuses
+        SequenceCache<SEQUENCE_CACHE_SIZE> seen_sequences;
+
+        /**
+         * @brief Gets the sequence number for a new status of the node
+         * 
+         * @return Sequence number
+         */
+        uint8_t next_sequence();
+
+        // stats message waiting to be sent, either the node's own or forwarded
+        StatsMessage pending_stats = StatsMessage();
+        bool is_stats_pending = false;
+
+        // time in milliseconds the node's own stats were last queued
+        uint32_t stats_ms = 0;
+
+        // trace message waiting to follow its status, either started or forwarded
+        TraceMessage pending_trace = TraceMessage();
+        bool is_trace_pending = false;
+
+        // time in milliseconds the traced status originated or was received
+        uint32_t trace_ms = 0;
+
+        /**
+         * @brief Sends the held trace message along with the status it follows
+         * 
+         * @param msg: message just sent carrying the traced status
+         * @param is_sent: true if the message was sent
+         */
+        void forward_trace(Message* msg, bool is_sent);
+
+        // nodes farther from the base station still to be sent a query,
+        // which accumulates queries received before they are forwarded
+        QueryMessage pending_query = QueryMessage();
+        bool is_query_pending = false;
+
+        // config waiting to be passed to nodes farther from the base station
+        // and the next nodes still to acknowledge it with one bit per node ID
+        ConfigMessage pending_config = ConfigMessage();
+        uint8_t config_hops[BITMAP_SIZE(LAYOUT_MAX_NODE_ID + 1)] = {0};
+        bool is_config_pending = false;
+
+        // next node ID to send the config to in the current round, number of
+        // rounds and when the last round ended in milliseconds
+        uint8_t config_hop_index = 0;
+        uint8_t num_config_attempts = 0;
+        uint32_t config_ms = 0;
+
+        // settings that can be changed over the air
+        uint8_t loop_delay_min_ms = 0;
+        uint8_t loop_delay_max_ms = 0;
+        uint8_t channel_checks_max = 0;
+
+        // ID the node takes on its next restart or CONFIG_KEEP
+        uint8_t configured_id = CONFIG_KEEP;
+
+        /**
+         * @brief Takes the settings of a config without applying them to the radio
+         * 
+         * Settings that are CONFIG_KEEP or out of range keep their current value.
+         * 
+         * @param settings: settings to take
+         */
+        void set_config(config_settings_t settings);
+
+        /**
+         * @brief Applies a config and stores it in EEPROM for later restarts
+         * 
+         * The radio's PA level and data rate are kept when some next node
+         * never acknowledged the config, so the node is not cut off from it.
+         * 
+         * @param msg: config to apply
+         * @param is_radio_switched: true if the radio takes the new settings
+         */
+        void apply_config(ConfigMessage* msg, bool is_radio_switched);
+
+        /**
+         * @brief Stores every current setting in EEPROM
+         */
+        void store_settings();
+
+        // links to candidate next nodes toward the base station
+        link_t links[NUM_NEXT_HOPS];
+
+        // time in milliseconds between heartbeats
+        uint32_t heartbeat_interval_ms = 0;
+
+        // time in milliseconds the next heartbeat is due
+        uint32_t next_heartbeat_ms = 0;
+
+        // time in milliseconds the node's status was last sent or queued
+        uint32_t status_sent_ms = 0;
+
+        /**
+         * @brief Pushes the next heartbeat back a jittered interval from now
+         */
+        void schedule_heartbeat();
+
+        /**
+         * @brief Transmit a message to sensor node or base station.
+         * 
+         * @param msg: Message to be transmitted
+         * @param size: Number of bytes of the message to transmit
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_message(Message* msg, uint8_t size);
 
         /**
-         * @brief Calculates a given sensor node's radio address based on the node ID
+         * @brief Attempts a single transmission of a message to its receiver
          * 
-         * @param node_id: ID of node to calculate address for
-         * @return The calculated radio address for the node
+         * @param msg: Message to be transmitted
+         * @param size: Number of bytes of the message to transmit
+         * @param max_attempts: Number of hardware retries to use
+         * @return True if successfully sent. Otherwise false
          */
-        uint32_t calculate_radio_address(uint8_t node_id);
+        bool transmit_attempt(Message* msg, uint8_t size, uint8_t max_attempts);
 
         /**
-         * @brief Calculates a given sensor node's radio channel based on the node ID
+         * @brief Gets the link to a neighboring node
          * 
-         * @param node_id: ID of node to calculate channel for
-         * @return The calculated radio channel for the node (0-125)
+         * @param node_id: ID of neighboring node
+         * @return Link to the node if it is a candidate next node. Otherwise NULL
          */
-        uint8_t calculate_radio_channel(uint8_t node_id);
+        link_t* get_link(uint8_t node_id);
+
+        /**
+         * @brief Records the result of a transmission to a neighboring node
+         * 
+         * @param node_id: ID of neighboring node
+         * @param is_sent: If the transmission was acknowledged
+         */
+        void update_link_quality(uint8_t node_id, bool is_sent);
+
+        /**
+         * @brief Tunes the auto retransmit settings of a link from a transmission
+         * 
+         * Clean links settle on a short delay and few retries, while a failure
+         * returns the link to the configured delay and attempts.
+         * 
+         * @param link: link the transmission was sent on
+         * @param is_sent: If the transmission was acknowledged
+         * @param num_retries: retransmissions the radio made
+         */
+        void tune_link(link_t* link, bool is_sent, uint8_t num_retries);
+
+        /**
+         * @brief Gets a candidate next node other than the provided one
+         * 
+         * @param node_id: ID of node to find an alternate for
+         * @return ID of alternate node on success. Otherwise -1
+         */
+        int16_t get_alternate_hop(uint8_t node_id);
 
 
     public:
@@ -93,17 +357,61 @@ class SensorNode {
          */
         tof_sensor_status_t get_sensor_status();
 
+        /**
+         * @brief Determines if the ToF sensor should be sampled
+         * 
+         * In low power mode the sensor is sampled on a fixed schedule. Otherwise
+         * it is sampled every time.
+         * 
+         * @return True if the sensor is due to be sampled. Otherwise false
+         */
+        bool is_sample_due();
+
         /**
          * @brief Determines if the last read sensor value differs from the current
          * 
          * Determines if the last read sensor value differs from the current. If a
          * sensor error occurs, false will be returned regardless of the prevous
-         * sensor status.
+         * sensor status. In continuous mode this does not wait for the sensor and
+         * returns false if no new range is ready.
          * 
          * @return If the ToF sensor status has changed since it was last read
          */
         bool is_sensor_status_changed();
 
+        /**
+         * @brief Sets how ToF sensor ranges are classified as occupied or vacant
+         * 
+         * @param config: classifier settings
+         * @return True if the settings are valid and were applied. Otherwise false
+         */
+        bool set_classifier_config(classifier_config_t config);
+
+        /**
+         * @brief Sets the time between heartbeats
+         * 
+         * @param interval_ms: time in milliseconds, must exceed the heartbeat jitter
+         * @return True if the interval is valid and was applied. Otherwise false
+         */
+        bool set_heartbeat_interval(uint32_t interval_ms);
+
+        /**
+         * @brief Determines if the node's status must be sent as a heartbeat
+         * 
+         * Sending or piggybacking the status for any reason postpones the
+         * heartbeat, so only nodes with nothing else to say transmit one.
+         * 
+         * @return True if a heartbeat is due. Otherwise false
+         */
+        bool is_heartbeat_due();
+
+        /**
+         * @brief Gets the time until the next heartbeat is due
+         * 
+         * @return Time in milliseconds
+         */
+        uint32_t get_time_until_heartbeat();
+
         /**
          * @brief Transmit update to sensor node or base station.
          * 
@@ -121,27 +429,274 @@ class SensorNode {
         bool transmit_update(uint8_t rx_node_id);
 
         /**
-         * @brief Determine if there is a message available to read
+         * @brief Transmit aggregated updates to sensor node or base station.
+         * 
+         * @param msg: Aggregate message to be transmitted
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_update(AggregateMessage* msg);
+
+        /**
+         * @brief Queues a node's status to be forwarded with other pending updates
+         * 
+         * Statuses of other nodes that are duplicates of, or older than, one
+         * already forwarded are dropped.
+         * 
+         * @param node_id: ID of node reporting its status
+         * @param is_vacant: Node's vacancy status
+         * @param sequence: Origin node's sequence number for the status
+         * @return True if successfully queued or dropped as a duplicate. Otherwise false
+         */
+        bool queue_update(uint8_t node_id, bool is_vacant, uint8_t sequence);
+
+        /**
+         * @brief Queues all statuses of an aggregate message to be forwarded
+         * 
+         * @param msg: Aggregate message containing statuses to queue
+         * @return True if all statuses were successfully queued. Otherwise false
+         */
+        bool queue_update(AggregateMessage* msg);
+
+        /**
+         * @brief Queues the node's own status to be sent with pending updates
+         * 
+         * @return True if successfully queued. Otherwise false
+         */
+        bool queue_status();
+
+        /**
+         * @brief Determines if the pending updates should be forwarded
+         * 
+         * Pending updates are ready once the oldest has waited for the
+         * aggregation window or no more updates can be queued. When synchronized
+         * to TDMA beacons, pending updates are instead ready in the node's slot.
+         * 
+         * @return True if pending updates are ready. Otherwise false
+         */
+        bool is_pending_update_ready();
+
+        /**
+         * @brief Transmit all pending updates to sensor node or base station.
+         * 
+         * The node's own status is piggybacked if it has not been sent for
+         * half a heartbeat interval. Pending updates are cleared regardless
+         * of transmission success.
+         * 
+         * @param rx_node_id: ID of receiving node
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_pending_updates(uint8_t rx_node_id);
+
+        /**
+         * @brief Answers a query and holds the rest of it to be forwarded
+         * 
+         * The node's own status is queued with the pending updates if it is
+         * a target. Targets reached through this node are added to the held
+         * query and any others are dropped.
+         * 
+         * @param msg: Query message received from a node closer to the base station
+         * @return True if the query was answered or forwarding is needed. Otherwise false
+         */
+        bool queue_query(QueryMessage* msg);
+
+        /**
+         * @brief Determines if the held query should be forwarded
+         * 
+         * When synchronized to TDMA beacons, queries are only ready in the node's slot.
+         * 
+         * @return True if a query is held. Otherwise false
+         */
+        bool is_query_ready();
+
+        /**
+         * @brief Applies a config and holds it to be passed on
+         * 
+         * Configs are passed to every node farther from the base station they
+         * are meant for. The node's own copy is applied once every one of them
+         * was sent, so a new data rate never cuts off a link still needed.
+         * 
+         * @param msg: received config message
+         * @return True if the config is new or must be passed on. Otherwise false
+         */
+        bool queue_config(ConfigMessage* msg);
+
+        /**
+         * @brief Determines if the held config should be passed on or applied
+         * 
+         * Next nodes that missed the config are sent it again every
+         * CONFIG_RETRY_MS until CONFIG_MAX_ATTEMPTS rounds were sent.
+         * 
+         * @return True if a config is due. Otherwise false
+         */
+        bool is_config_ready();
+
+        /**
+         * @brief Passes the held config to one node farther from the base
+         *      station that has not acknowledged it yet
+         * 
+         * Applies the config once every next node acknowledged it or the
+         * attempts ran out, in which case the radio keeps its PA level and
+         * data rate. Switching on hop by hop acknowledgements rather than a
+         * commit from the sink means a node can switch before the nodes
+         * toward the sink do, see CONFIG_FALLBACK_MS.
+         * 
+         * @return False if sending the config failed. Otherwise true
+         */
+        bool transmit_config();
+
+        /**
+         * @brief Gets a random delay for the main loop within the configured range
+         * 
+         * @return Delay in milliseconds
+         */
+        uint32_t get_loop_delay_ms();
+
+        /**
+         * @brief Gets the ID the node was configured to take over the air
+         * 
+         * Reads the stored config, so it can be called before the node exists.
+         * 
+         * @param node_id: ID to use if none was configured
+         * @return Configured ID of the node
+         */
+        static uint8_t get_configured_id(uint8_t node_id);
+
+        /**
+         * @brief Forwards the held query to one node farther from the base station
          * 
-         * @return True if a message is available. Otherwise false
+         * Only the targets reached through that node are sent, the rest stay
+         * held for the next call. Targets are released regardless of
+         * transmission success since the base station queries again.
+         * 
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_query();
+
+        /**
+         * @brief Holds another node's stats message to be forwarded
+         * 
+         * Only one stats message is held at a time, so others are dropped
+         * until it is sent.
+         * 
+         * @param msg: Stats message to forward
+         * @return True if successfully queued. Otherwise false
+         */
+        bool queue_stats(StatsMessage* msg);
+
+        /**
+         * @brief Determines if a stats message should be sent
+         * 
+         * Queues the node's own counters every STATS_INTERVAL_MS when no other
+         * stats message is held. When synchronized to TDMA beacons, stats are
+         * only ready in the node's slot.
+         * 
+         * @return True if a stats message is ready. Otherwise false
+         */
+        bool is_stats_ready();
+
+        /**
+         * @brief Transmit the held stats message to sensor node or base station.
+         * 
+         * The stats message is released regardless of transmission success.
+         * 
+         * @param rx_node_id: ID of receiving node
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_stats(uint8_t rx_node_id);
+
+        /**
+         * @brief Starts tracing the node's next status
+         * 
+         * Does nothing unless TRACE_ENABLED.
+         */
+        void start_trace();
+
+        /**
+         * @brief Holds another node's trace message to be forwarded
+         * 
+         * Only one trace message is held at a time, so others are dropped
+         * until it is sent.
+         * 
+         * @param msg: Trace message to forward
+         * @return True if successfully queued. Otherwise false
          */
-        bool is_message();
+        bool queue_trace(TraceMessage* msg);
 
         /**
-         * @brief Gets a message from the message queue
+         * @brief Determines if a held trace message missed its status
          * 
-         * @param buffer: buffer to hold message
-         * @param size: size of buffer
-         * @return Number of bytes read
+         * Trace messages normally go out right after the status they follow.
+         * 
+         * @return True if a trace message is held with no pending updates. Otherwise false
          */
-        bool read_message(uint8_t** buffer, uint8_t size);
+        bool is_trace_ready();
 
         /**
-         * @brief Get the ID of the node
+         * @brief Adds this node's hop and transmits the held trace message
+         * 
+         * The trace message is released regardless of transmission success.
+         * 
+         * @param rx_node_id: ID of receiving node
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_trace(uint8_t rx_node_id);
+
+        /**
+         * @brief Idles until there is something to do or a timeout occurs
+         * 
+         * In low power mode the microcontroller sleeps and the radio is only
+         * powered during the listen window of each listen cycle. Otherwise this
+         * waits for a message to arrive.
+         * 
+         * @param timeout_ms: maximum time to idle in milliseconds
+         */
+        void idle(uint32_t timeout_ms);
+
+        /**
+         * @brief Synchronizes the TDMA schedule to a received beacon
+         * 
+         * @param msg: Received beacon message
+         * @return True if the beacon was new and should be relayed. Otherwise false
+         */
+        bool synchronize(BeaconMessage* msg);
+
+        /**
+         * @brief Relays the most recent beacon to nodes farther from the base station
+         * 
+         * @return True if successfully sent. Otherwise false
+         */
+        bool transmit_beacon();
+
+        /**
+         * @brief Determines if transmissions are scheduled in TDMA slots
+         * 
+         * @return True if synchronized to a recent beacon. Otherwise false
+         */
+        bool is_synchronized();
+
+        /**
+         * @brief Determines if the node may transmit now
+         * 
+         * @return True if in the node's slot or not synchronized. Otherwise false
+         */
+        bool is_transmit_slot();
+
+        /**
+         * @brief Gets the time until the node may transmit
+         * 
+         * @return Time in milliseconds
+         */
+        uint32_t get_time_until_slot();
+
+        /**
+         * @brief Gets the next node ID for forwarding an ingress message
+         * 
+         * Prefers the candidate next node with the best delivery history and
+         * occasionally probes the other so a recovered link is noticed.
          * 
-         * @return ID of the node
+         * @return Next node ID on success. Otherwise -1
          */
-        uint8_t get_id();
+        int16_t get_next_hop();
 };
 
 #endif /* _SENSOR_NODE_HPP_ */
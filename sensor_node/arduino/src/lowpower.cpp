@@ -0,0 +1,114 @@
+/**
+* @brief: Contains the implementation of the functions for low power sleep.
+* @file: lowpower.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+// local dependencies
+#include "lowpower.hpp"
+
+
+// number of watchdog timer periods
+#define NUM_WDT_PERIODS 10
+
+// milliseconds of sleep for each watchdog timer period (WDTO_15MS to WDTO_8S)
+static const uint16_t wdt_period_ms[NUM_WDT_PERIODS] PROGMEM = {
+    16, 32, 64, 125, 250, 500, 1000, 2000, 4000, 8000
+};
+
+// millisecond counter behind millis() from the Arduino core
+extern volatile unsigned long timer0_millis;
+
+// watchdog timer woke the microcontroller
+static volatile bool is_wdt_wake = false;
+
+
+/**
+ * @brief Handles the watchdog timer interrupt
+ */
+ISR(WDT_vect) {
+
+    is_wdt_wake = true;
+}
+
+
+/**
+ * @brief Starts the watchdog timer in interrupt mode
+ * 
+ * @param period: watchdog timer period (WDTO_15MS to WDTO_8S)
+ */
+static void start_wdt_interrupt(uint8_t period) {
+
+    // convert period to prescaler bits
+    uint8_t prescaler = (period & 0x07) | ((period & 0x08) ? (1 << WDP3) : 0);
+
+    noInterrupts();
+    wdt_reset();
+
+    // timed sequence to change the watchdog configuration
+    MCUSR &= ~(1 << WDRF);
+    WDTCSR = (1 << WDCE) | (1 << WDE);
+    WDTCSR = (1 << WDIE) | prescaler;
+
+    interrupts();
+}
+
+
+uint32_t low_power_sleep(uint32_t duration_ms) {
+
+    uint32_t slept_ms = 0;
+
+    // turn off the ADC while sleeping
+    uint8_t adc_config = ADCSRA;
+    ADCSRA &= ~(1 << ADEN);
+
+    while (LOW_POWER_MIN_SLEEP_MS <= (duration_ms - slept_ms)) {
+
+        // find longest watchdog period that fits in the remaining time
+        uint8_t period = NUM_WDT_PERIODS - 1;
+        while (0 < period && pgm_read_word(&wdt_period_ms[period]) > (duration_ms - slept_ms)) {
+            period--;
+        }
+
+        uint16_t period_ms = pgm_read_word(&wdt_period_ms[period]);
+
+        is_wdt_wake = false;
+        start_wdt_interrupt(period);
+
+        // enter power-down sleep
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        noInterrupts();
+        sleep_enable();
+        sleep_bod_disable();
+        interrupts();
+        sleep_cpu();
+        sleep_disable();
+
+        wdt_disable();
+
+        // woken by an external interrupt so the time slept is unknown
+        if (false == is_wdt_wake) {
+            break;
+        }
+
+        slept_ms += period_ms;
+
+        // account for time slept since millis() was stopped
+        noInterrupts();
+        timer0_millis += period_ms;
+        interrupts();
+    }
+
+    ADCSRA = adc_config;
+
+    return slept_ms;
+}
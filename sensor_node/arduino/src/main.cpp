@@ -12,6 +12,7 @@
 #include <Adafruit_VL6180X.h>
 
 // local libraries
+#include <Counters.h>
 #include <Log.h>
 
 // local dependencies
@@ -19,30 +20,196 @@
 #include "parkingmap.hpp"
 
 
-// unique ID for node
+// unique ID for node unless another was configured over the air
 #define NODE_ID 10
 
 // baud rate for serial connection
 #define SERIAL_BAUD 9600
 
 
-#define MAIN_LOOP_DELAY_MIN_MS 75   // minimum delay in main loop in milliseconds
-#define MAIN_LOOP_DELAY_MAX_MS 150  // maximum delay in main loop in milliseconds
+// parking sensor node, which takes the ID it was last configured with over the air
+SensorNode node = SensorNode(SensorNode::get_configured_id(NODE_ID));
 
-// number of loop iterations without transmitting a message
-// before sending out a heartbeat
-#define LOOPS_BEFORE_HEARTBEAT 25
 
-// size of message buffer
-#define MSG_BUFFER_SIZE 32
+/**
+ * @brief Handles a received UPDATE message.
+ * 
+ * @param msg: received message
+ */
+static void handle_update(MessageView* msg) {
+
+    UpdateMessage* update_msg = msg->as_update();
+
+    // message is incomplete
+    if (NULL == update_msg) {
+        WARN("Malformed UPDATE message received")
+        return;
+    }
+
+    INFO("Received UPDATE message from Node %d", update_msg->get_tx_id())
+
+    // hold update to forward with other pending updates
+    if (false == node.queue_update(update_msg->get_node_id(), update_msg->get_is_vacant(), update_msg->get_sequence())) {
+        WARN("Failed to queue update from Node %d", update_msg->get_node_id())
+    }
+}
+
+
+/**
+ * @brief Handles a received AGGREGATE message.
+ * 
+ * @param msg: received message
+ */
+static void handle_aggregate(MessageView* msg) {
+
+    AggregateMessage* aggregate_msg = msg->as_aggregate();
+
+    // message is incomplete
+    if (NULL == aggregate_msg) {
+        WARN("Malformed AGGREGATE message received")
+        return;
+    }
+
+    INFO("Received AGGREGATE message from Node %d", aggregate_msg->get_tx_id())
+
+    // hold updates to forward with other pending updates
+    if (false == node.queue_update(aggregate_msg)) {
+        WARN("Failed to queue all updates from Node %d", aggregate_msg->get_tx_id())
+    }
+}
 
 
-// parking sensor node
-SensorNode node = SensorNode(NODE_ID);
+/**
+ * @brief Handles a received BEACON message.
+ * 
+ * @param msg: received message
+ */
+static void handle_beacon(MessageView* msg) {
+
+    BeaconMessage* beacon_msg = msg->as_beacon();
+
+    // message is incomplete
+    if (NULL == beacon_msg) {
+        WARN("Malformed BEACON message received")
+        return;
+    }
+
+    // only relay the first copy of each beacon
+    if (false == node.synchronize(beacon_msg)) {
+        return;
+    }
+
+    // pass beacon on to nodes farther from the base station
+    if (false == node.transmit_beacon()) {
+        WARN("Failed to relay beacon")
+    }
+}
+
+
+/**
+ * @brief Handles a received STATS message.
+ * 
+ * @param msg: received message
+ */
+static void handle_stats(MessageView* msg) {
+
+    StatsMessage* stats_msg = msg->as_stats();
+
+    // message is incomplete
+    if (NULL == stats_msg) {
+        WARN("Malformed STATS message received")
+        return;
+    }
+
+    // hold stats to forward toward the base station
+    if (false == node.queue_stats(stats_msg)) {
+        WARN("Dropped stats of Node %d", stats_msg->get_node_id())
+    }
+}
+
+
+/**
+ * @brief Handles a received TRACE message.
+ * 
+ * @param msg: received message
+ */
+static void handle_trace(MessageView* msg) {
+
+    TraceMessage* trace_msg = msg->as_trace();
+
+    // message is incomplete
+    if (NULL == trace_msg) {
+        WARN("Malformed TRACE message received")
+        return;
+    }
+
+    // hold trace to follow the status toward the base station
+    if (false == node.queue_trace(trace_msg)) {
+        WARN("Dropped trace of Node %d", trace_msg->get_origin_id())
+    }
+}
+
+
+/**
+ * @brief Handles a received QUERY message.
+ * 
+ * @param msg: received message
+ */
+static void handle_query(MessageView* msg) {
+
+    QueryMessage* query_msg = msg->as_query();
+
+    // message is incomplete
+    if (NULL == query_msg) {
+        WARN("Malformed QUERY message received")
+        return;
+    }
+
+    INFO("Received QUERY message from Node %d", query_msg->get_tx_id())
+
+    // answer and hold the rest to pass on to nodes farther away
+    if (false == node.queue_query(query_msg)) {
+        INFO("Query from Node %d has nothing for this node", query_msg->get_tx_id())
+    }
+}
 
-// counter for tracking loop iterations since the last
-// message was transmitted
-uint8_t loops_since_last_transmission = 0;
+
+/**
+ * @brief Handles a received CONFIG message.
+ * 
+ * @param msg: received message
+ */
+static void handle_config(MessageView* msg) {
+
+    ConfigMessage* config_msg = msg->as_config();
+
+    // message is incomplete
+    if (NULL == config_msg) {
+        WARN("Malformed CONFIG message received")
+        return;
+    }
+
+    INFO("Received CONFIG message from Node %d", config_msg->get_tx_id())
+
+    // pass on to nodes farther away before applying it
+    if (false == node.queue_config(config_msg)) {
+        INFO("Config version %d has nothing for this node", config_msg->get_version())
+    }
+}
+
+
+// handlers for each type of message a sensor node reacts to
+static const message_handler_t message_handlers[] = {
+    {MESSAGE_UPDATE, handle_update},
+    {MESSAGE_AGGREGATE, handle_aggregate},
+    {MESSAGE_BEACON, handle_beacon},
+    {MESSAGE_STATS, handle_stats},
+    {MESSAGE_TRACE, handle_trace},
+    {MESSAGE_QUERY, handle_query},
+    {MESSAGE_CONFIG, handle_config}
+};
+
+#define NUM_MESSAGE_HANDLERS (sizeof(message_handlers) / sizeof(message_handlers[0]))
 
 /**
  * @brief Initialize all necessary objects and variables.
@@ -73,113 +240,162 @@ void setup() {
  */
 void loop() {
 
-    // track iterations since last transmission
-    loops_since_last_transmission++;
+    counters_loop_begin();
+
+    bool is_heartbeat = node.is_heartbeat_due();
+    bool is_changed = (true == node.is_sample_due() && true == node.is_sensor_status_changed());
 
     // determine if parking space status has changed or time for heartbeat
-    if ((true == node.is_sensor_status_changed())
-        || LOOPS_BEFORE_HEARTBEAT <= loops_since_last_transmission) {
+    if (true == is_changed || true == is_heartbeat) {
+
+        // time how long the change takes to reach the base station
+        if (true == is_changed) {
+            node.start_trace();
+        }
 
         // determine recepient
-        int16_t rx_id = get_next_ingress_node(node.get_id());
+        int16_t rx_id = node.get_next_hop();
+
+        // send status in the node's TDMA slot along with pending updates
+        if (true == node.is_synchronized()) {
+
+            if (false == node.queue_status()) {
+                WARN("Failed to queue update for TDMA slot")
+            }
+        }
 
         // no recepient available
-        if (0 > rx_id) {
+        else if (0 > rx_id) {
             WARN("Nobody to send update to")
         }
 
         else {
             // transmit update
             if (false == node.transmit_update((uint8_t)rx_id)) {
-                ERROR("Failed to transmit update message to Node " + rx_id)
+                ERROR("Failed to transmit update message to Node %d", rx_id)
             }
 
             // heartbeat message successfully sent
-            else if (LOOPS_BEFORE_HEARTBEAT <= loops_since_last_transmission) {
-                INFO("heartbeat update message sent to Node " + + rx_id)
+            else if (true == is_heartbeat) {
+                INFO("heartbeat update message sent to Node %d", rx_id)
             }
 
             // update message successfully sent
             else {
-                INFO("update message sent to Node " + + rx_id)
+                INFO("update message sent to Node %d", rx_id)
             }
-
-            // reset heartbeat iteration counter
-            loops_since_last_transmission = 0;
         }
     }
 
-    // check if a message has been received
-    else if(true == node.is_message()) {
+    // forward updates received from other nodes
+    else if (true == node.is_pending_update_ready()) {
 
-        uint8_t buffer[MSG_BUFFER_SIZE];
-        memset(buffer, 0, sizeof(buffer));
+        // determine recepient
+        int16_t rx_id = node.get_next_hop();
 
-        if (false == node.read_message((uint8_t**)(&buffer), (uint8_t)sizeof(buffer))) {
-            ERROR("Failed to read message");
+        // no recepient available
+        if (0 > rx_id) {
+            WARN("Nobody to send update to")
         }
 
         else {
-            // convert buffer to Message
-            Message msg = Message();
-            memcpy(&msg, buffer, sizeof(msg));
-
-            // verify message is for node
-            if (node.get_id() != msg.get_rx_id()) {
-                WARN("Message intended for Node " + msg.get_rx_id() + " not Node " + node.get_id());
+            // forward the pending updates
+            if (false == node.transmit_pending_updates((uint8_t)rx_id)) {
+                ERROR("Failed to transmit aggregate message to %d", rx_id)
             }
+        }
+    }
 
-            // react accordingly based on message type
-            else {
+    // pass a query on toward the nodes it asks for
+    else if (true == node.is_query_ready()) {
 
-                uint8_t type = msg.get_type();
-                switch(type) {
+        if (false == node.transmit_query()) {
+            WARN("Failed to forward query message")
+        }
+    }
 
-                    case MESSAGE_UPDATE: {
+    // pass on or apply a received config
+    else if (true == node.is_config_ready()) {
 
-                        INFO("Received UPDATE message from Node " + msg.get_tx_id())
-                        
-                        // convert buffer to UpdateMessage
-                        UpdateMessage update_msg = UpdateMessage();
-                        memcpy(&update_msg, buffer, sizeof(update_msg));
+        if (false == node.transmit_config()) {
+            WARN("Failed to forward config message")
+        }
+    }
 
-                        // determine recepient
-                        int16_t rx_id = get_next_ingress_node(node.get_id());
+    // send a trace whose status already went out without it
+    else if (true == node.is_trace_ready()) {
 
-                        // no recepient available
-                        if (0 > rx_id) {
-                            WARN("Nobody to send update to")
-                        }
+        // determine recepient
+        int16_t rx_id = node.get_next_hop();
 
-                        else {
-                            // create new message to forward
-                            uint8_t tx_id = node.get_id();
-                            uint8_t node_id = update_msg.get_node_id();
-                            bool is_vacant = update_msg.get_is_vacant();
-                            UpdateMessage new_msg = UpdateMessage(rx_id, tx_id, node_id, is_vacant);
+        // no recepient available
+        if (0 > rx_id) {
+            WARN("Nobody to send trace to")
+        }
 
-                            // forward the message
-                            if (false == node.transmit_update(&new_msg)) {
-                                ERROR("Failed to transmit update message to " + rx_id)
-                            }
+        else if (false == node.transmit_trace((uint8_t)rx_id)) {
+            WARN("Failed to transmit trace message to %d", rx_id)
+        }
+    }
 
-                            // reset heartbeat iteration counter
-                            loops_since_last_transmission = 0;
-                        }
+    // send the node's own or forwarded stats
+    else if (true == node.is_stats_ready()) {
 
-                        break;
-                    }
+        // determine recepient
+        int16_t rx_id = node.get_next_hop();
 
-                    default:
-                        WARN("Unknown message type received")
-                        break;
-                }
-            }
+        // no recepient available
+        if (0 > rx_id) {
+            WARN("Nobody to send stats to")
+        }
+
+        else if (false == node.transmit_stats((uint8_t)rx_id)) {
+            WARN("Failed to transmit stats message to %d", rx_id)
         }
     }
 
-    // nothing to do
+    // check if a message has been received
+    else if(true == node.is_message()) {
+
+        MessageView msg = MessageView();
+
+        if (false == node.receive_message(&msg) || false == msg.is_valid()) {
+            ERROR("Failed to read message");
+        }
+
+        // verify message is for node
+        else if (node.get_id() != msg.header()->get_rx_id() && BROADCAST_ID != msg.header()->get_rx_id()) {
+            WARN("Message intended for Node %d not Node %d", msg.header()->get_rx_id(), node.get_id());
+        }
+
+        // verify the sender matches the neighbor pipe it arrived on
+        else if (0 <= node.get_message_sender() && node.get_message_sender() != msg.header()->get_tx_id()) {
+            WARN("Message from Node %d arrived on pipe of Node %d", msg.header()->get_tx_id(), node.get_message_sender());
+        }
+
+        // react accordingly based on message type
+        else if (false == dispatch_message(&msg, message_handlers, NUM_MESSAGE_HANDLERS)) {
+            WARN("Unknown message type received")
+        }
+
+        node.release_message();
+    }
+
+    // nothing to do so idle until a message arrives
     else {
-        delay(random(MAIN_LOOP_DELAY_MIN_MS, MAIN_LOOP_DELAY_MAX_MS));
+        // passes that only idle do not count toward the loop timing
+        counters_loop_cancel();
+
+        // write out buffered log records while there is time
+        log_drain();
+
+#if LOW_POWER_ENABLED
+        // sleep until the next scheduled sample or listen window
+        node.idle(UINT32_MAX);
+#else
+        node.idle(node.get_loop_delay_ms());
+#endif
     }
+
+    counters_loop_end();
 }
@@ -7,89 +7,239 @@
 
 // standard libraries
 #include <Arduino.h>
+#include <avr/pgmspace.h>
 
 // local libraries
 #include <Log.h>
+#include <Layout.h>
 
 // local dependencies
 #include "parkingmap.hpp"
 
 
-#define NUM_ROWS 4  // number of rows in the parking map
-#define NUM_COLS 4  // number of columns in the parking map
+#define NUM_ROWS LAYOUT_GRID_ROWS  // number of rows in the parking map
+#define NUM_COLS LAYOUT_GRID_COLS  // number of columns in the parking map
 
-#define NOT_SPOT -1  // represent space not for 
 
-#define BASE_STATION_ID 0   // ID of base station
-#define BASE_STATION_ROW 0  // row base station is located on
-#define BASE_STATION_COL 1  // column base station is located on
+#define NO_ROUTE LAYOUT_NONE   // represents a missing next hop in the routing table
 
+// largest node ID in the parking map
+#define MAX_NODE_ID LAYOUT_MAX_NODE_ID
 
-static int16_t parking_map[NUM_ROWS][NUM_COLS] = {
-    {NOT_SPOT, 0, 1, 2},
-    {5, 4, 3, NOT_SPOT},
-    {8, 7, 6 , NOT_SPOT},
-    {NOT_SPOT, NOT_SPOT, 10, 9}
-};
 
+/**
+ * @brief Gets the node at a coordinate of the parking map
+ * 
+ * @param row: row of the coordinate
+ * @param col: column of the coordinate
+ * @return ID of node at the coordinate. Otherwise NO_ROUTE
+ */
+static constexpr uint8_t node_at(int16_t row, int16_t col) {
+
+    // coordinate is off the parking map
+    if (0 > row || NUM_ROWS <= row || 0 > col || NUM_COLS <= col) {
+        return NO_ROUTE;
+    }
 
-int16_t get_next_ingress_node(uint8_t node_id) {
+    // returns NO_ROUTE if the coordinate does not have a node
+    return layout_node_at_grid(LAYOUT_CELL(row, col));
+}
 
-    // zero is not a valid sensor node ID
-    if (BASE_STATION_ID == node_id) {
-        return NOT_SPOT;
-    }
 
-    // find coordinates of current node
-    for (uint8_t i = 0; i < NUM_ROWS; i++) {
-        for (uint8_t j = 0; j < NUM_COLS; j++) {
+// candidate next hops toward a sink for every node
+struct routing_table_t {
 
-            // current coordinate does not have a node
-            if (NOT_SPOT == parking_map[i][j]) {
-                continue;
-            }
+    uint8_t next_hops[MAX_NODE_ID + 1][NUM_NEXT_HOPS];
+
+    // TDMA transmit slot of every node
+    uint8_t tdma_slots[MAX_NODE_ID + 1];
+
+    /**
+     * @brief Generates the routing table from the parking map
+     */
+    constexpr routing_table_t() : next_hops(), tdma_slots() {
 
-            // current node found
-            else if (node_id == parking_map[i][j]) {
+        for (uint8_t id = 0; id <= MAX_NODE_ID; id++) {
+            next_hops[id][0] = NO_ROUTE;
+            next_hops[id][1] = NO_ROUTE;
+        }
+
+        for (int16_t i = 0; i < NUM_ROWS; i++) {
+            for (int16_t j = 0; j < NUM_COLS; j++) {
+
+                uint8_t id = node_at(i, j);
+
+                // coordinate has no node or is a sink
+                if (NO_ROUTE == id || true == layout_is_sink(id)) {
+                    continue;
+                }
 
-                // nodes in same row as base station always go down a column
-                if (BASE_STATION_ROW == i) {
-                    return parking_map[i][j - 1];
+                // head toward the nearest sink, which is at least as near to
+                // every next hop, so routes always end at a sink
+                uint8_t sink_cell = layout_grid_cell(layout_nearest_sink(LAYOUT_CELL(i, j)));
+                int16_t sink_row = LAYOUT_ROW(sink_cell);
+                int16_t sink_col = LAYOUT_COL(sink_cell);
+                int8_t row_direction = (sink_row < i) ? -1 : 1;
+                int8_t col_direction = (sink_col < j) ? -1 : 1;
+
+                uint8_t col_hop = NO_ROUTE;
+                uint8_t row_hop = NO_ROUTE;
+
+                // nodes in same row as the sink always go along the row
+                if (sink_row == i) {
+                    col_hop = node_at(i, j + col_direction);
+                    row_hop = col_hop;
                 }
 
-                // nodes in same column as base station always go down a row
-                if (BASE_STATION_COL == j) {
-                    return parking_map[i - 1][j];
+                // nodes in same column as the sink always go along the column
+                else if (sink_col == j) {
+                    row_hop = node_at(i + row_direction, j);
+                    col_hop = row_hop;
+                }
+
+                // otherwise either neighboring column or neighboring row
+                else {
+                    col_hop = node_at(i, j + col_direction);
+                    row_hop = node_at(i + row_direction, j);
+
+                    // only one neighbor available so always use it
+                    if (NO_ROUTE == col_hop) {
+                        col_hop = row_hop;
+                    }
+
+                    else if (NO_ROUTE == row_hop) {
+                        row_hop = col_hop;
+                    }
                 }
 
-                // calculate column direction
-                int8_t direction = (BASE_STATION_COL < j) ? -1 : 1;
+                next_hops[id][0] = col_hop;
+                next_hops[id][1] = row_hop;
+            }
+        }
+
+        // longest number of hops from every node to a sink
+        uint8_t depths[MAX_NODE_ID + 1] = {};
+        uint8_t max_depth = 0;
 
-                // determine if next node is neighboring column
-                if (0 == (random() % 2)) {
+        // routes only lead toward a sink so depths settle
+        // after at most one pass per node
+        for (uint8_t pass = 0; pass <= MAX_NODE_ID; pass++) {
+            for (uint8_t id = 1; id <= MAX_NODE_ID; id++) {
+                for (uint8_t k = 0; k < NUM_NEXT_HOPS; k++) {
 
-                    // no neighboring column node so next node is down a row
-                    if (NOT_SPOT != parking_map[i][j + direction]) {
-                        return parking_map[i][j + direction];
+                    uint8_t hop = next_hops[id][k];
+
+                    if (NO_ROUTE != hop && depths[id] < depths[hop] + 1) {
+                        depths[id] = depths[hop] + 1;
                     }
                 }
 
-                // next node is down a row
-                if (NOT_SPOT != parking_map[i - 1][j]) {
-                    return parking_map[i - 1][j];
+                if (max_depth < depths[id]) {
+                    max_depth = depths[id];
                 }
+            }
+        }
+
+        // farthest nodes transmit first so updates pipeline toward the
+        // base station within one superframe
+        uint8_t slot = 0;
+        for (uint8_t id = 0; id <= MAX_NODE_ID; id++) {
+            tdma_slots[id] = NO_ROUTE;
+        }
+
+        for (uint8_t depth = max_depth; depth > 0; depth--) {
+            for (uint8_t id = 1; id <= MAX_NODE_ID; id++) {
 
-                // no neighboring row node so next node is over a column
-                if (NOT_SPOT != parking_map[i][j + direction]) {
-                    return parking_map[i][j + direction];
+                if (depth == depths[id]) {
+                    tdma_slots[id] = slot;
+                    slot++;
                 }
+            }
+        }
+    }
 
-                // no next node
-                return NOT_SPOT;
+    /**
+     * @brief Determines if every sensor node has a route to a sink
+     * 
+     * @return True if every sensor node in the layout has a next hop. Otherwise false
+     */
+    constexpr bool is_complete() const {
+
+        for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+            uint8_t id = layout_nodes[i].node_id;
+
+            if (false == layout_is_sink(id) && NO_ROUTE == next_hops[id][0]) {
+                return false;
             }
         }
+
+        return true;
+    }
+};
+
+static const routing_table_t routing_table PROGMEM = routing_table_t();
+
+static_assert(routing_table_t().is_complete(), "every sensor node needs a route to a sink, check the layout");
+
+
+int16_t get_ingress_node_candidate(uint8_t node_id, uint8_t index) {
+
+    // IDs must be on the map
+    if (MAX_NODE_ID < node_id || NUM_NEXT_HOPS <= index) {
+        return NOT_SPOT;
+    }
+
+    uint8_t next_hop = pgm_read_byte(&routing_table.next_hops[node_id][index]);
+
+    // no next node, which includes sinks since they do not forward
+    if (NO_ROUTE == next_hop) {
+        return NOT_SPOT;
+    }
+
+    return next_hop;
+}
+
+
+int16_t get_next_egress_node(uint8_t node_id, uint8_t dest_id) {
+
+    uint8_t hop = dest_id;
+
+    // walk the destination's route toward its sink until it
+    // reaches the current node, routes have at most one hop per node
+    for (uint8_t i = 0; i <= MAX_NODE_ID; i++) {
+
+        int16_t next_hop = get_ingress_node_candidate(hop, 0);
+
+        // reached a sink without passing the current node
+        if (NOT_SPOT == next_hop) {
+            return NOT_SPOT;
+        }
+
+        if (node_id == next_hop) {
+            return hop;
+        }
+
+        hop = next_hop;
     }
 
-    // invalide node ID
     return NOT_SPOT;
 }
+
+
+int16_t get_tdma_slot(uint8_t node_id) {
+
+    // node is not on the map
+    if (MAX_NODE_ID < node_id) {
+        return NOT_SPOT;
+    }
+
+    uint8_t slot = pgm_read_byte(&routing_table.tdma_slots[node_id]);
+
+    // node does not transmit
+    if (NO_ROUTE == slot) {
+        return NOT_SPOT;
+    }
+
+    return slot;
+}
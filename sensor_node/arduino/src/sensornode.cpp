@@ -14,26 +14,17 @@
 #include <RF24.h>
 
 // local libraries
+#include <Counters.h>
+#include <Layout.h>
 #include <Log.h>
 #include <Message.h>
 
 // local dependencies
 #include "sensornode.hpp"
+#include "lowpower.hpp"
 
 
-// base station's node ID
-#define BASE_STATION_ID 0
-
-// special base station address since 0x00000000 is not a valid address
-#define BASE_STATION_ADDRESS 0xBAD1DEA5
-
-#define RF24_CHANNEL_SPACING 5  // number of channels between a valid node channel
-#define RF24_READING_PIPE 1     // reading pipe for the NRF24L01
-
-#define MAX_SEND_ATTEMPTS 15    // maximum number of attempts to send a message
-#define FAILED_SEND_DELAY 15    // minimum delay between sending message attempts
-
-// number of attempts to wait for the channel to be open if it is busy
+// default number of attempts to wait for the channel to be open if it is busy
 #define CHANNEL_CHECKS_MAX  10
 
 // minimum time to wait if the channel is busy before sending in milliseconds
@@ -42,37 +33,116 @@
 // maximum time to wait if the channel is busy before sending in milliseconds
 #define CHANNEL_BUSY_DELAY_MAX_MS 100
 
+// maximum time in milliseconds to hold pending updates before forwarding
+#define AGGREGATE_WINDOW_MS 250
 
-SensorNode::SensorNode(uint8_t node_id) {
+#define HEARTBEAT_INTERVAL_MS 30000 // default time between heartbeats in milliseconds
+#define HEARTBEAT_JITTER_MS 500     // maximum random offset applied to each heartbeat
 
-    this->node_id = node_id;
+// number of attempts to send a message over an unhealthy link that has an alternate
+#define PROBE_SEND_ATTEMPTS 3
 
-    this->radio_address = this->calculate_radio_address(node_id);
-    this->radio_channel = this->calculate_radio_channel(node_id);
-}
+#define LINK_QUALITY_INITIAL 192    // assumed quality of a link before any transmission
+#define LINK_QUALITY_HEALTHY 96     // minimum quality of a link considered healthy
+#define LINK_QUALITY_MARGIN 32      // quality difference below which links are equivalent
+#define LINK_QUALITY_WEIGHT_SHIFT 3 // moving average weight of a new result (1/8)
+
+// one in this many selections uses the less preferred link to probe it
+#define LINK_PROBE_ODDS 16
+
+// minimum quality of a link before its power amplifier level is lowered
+#define LINK_QUALITY_STRONG 240
+
+#define LINK_RETRIES_INITIAL 240    // assumed retries of a link before any transmission (15 in 1/16 steps)
+#define LINK_RETRIES_WEIGHT_SHIFT 2 // moving average weight of a new retry count (1/4)
+#define LINK_RETRIES_MARGIN 2       // attempts allowed beyond twice a link's average retries
+#define LINK_RETRIES_SLOW 2         // retries of a delivered message that lengthen the retry delay
+#define LINK_RETRY_DELAY_MIN 1      // shortest auto retransmit delay (500 us, valid at every data rate)
+
+#define CLASSIFIER_OCCUPIED_MM 180  // default range at or below which a space is occupied
+#define CLASSIFIER_VACANT_MM 200    // default range at or above which a space is vacant
+#define CLASSIFIER_NUM_AGREE 3      // default samples that must agree to change status
+#define CLASSIFIER_NUM_WINDOW 4     // default most recent samples considered
+
+// maximum number of samples the sample history can hold
+#define CLASSIFIER_MAX_WINDOW 8
+
+// time between ToF sensor samples in low power mode in milliseconds
+#define SENSOR_SAMPLE_INTERVAL_MS 1000
+
+// time between ToF sensor ranges in continuous mode in milliseconds (10-2550)
+#if LOW_POWER_ENABLED
+#define TOF_RANGE_PERIOD_MS SENSOR_SAMPLE_INTERVAL_MS
+#else
+#define TOF_RANGE_PERIOD_MS 50
+#endif
+
+// time to stop transmitting before the end of a TDMA slot in milliseconds
+#define TDMA_GUARD_MS 5
+
+// number of missed beacons before TDMA slots are abandoned
+#define BEACON_MISSES_MAX 3
+
+// maximum random delay before relaying a beacon in milliseconds
+#define BEACON_JITTER_MS 5
+
+// Every node powers its radio for the first LISTEN_WINDOW_MS of each
+// LISTEN_PERIOD_MS cycle. Senders retry every LISTEN_RETRY_INTERVAL_MS for a
+// full cycle and sleep in between, so a retry always lands in a listen window
+// while bounding the added latency per hop to LISTEN_PERIOD_MS.
+#define LISTEN_PERIOD_MS 500    // length of a radio listen cycle in milliseconds
+#define LISTEN_WINDOW_MS 100    // time the radio listens each cycle in milliseconds
+#define LISTEN_RETRY_INTERVAL_MS (LISTEN_WINDOW_MS / 2) // time between retries to a sleeping receiver
 
+// number of retries needed to cover a full listen cycle
+#define LISTEN_RETRIES_MAX (LISTEN_PERIOD_MS / LISTEN_RETRY_INTERVAL_MS)
 
-uint32_t SensorNode::calculate_radio_address(uint8_t node_id) {
+// time between the node's stats messages in milliseconds
+#define STATS_INTERVAL_MS 60000
 
-    // base station has special non-calculated address
-    if (BASE_STATION_ID == node_id) {
-        return BASE_STATION_ADDRESS;
+#define MAIN_LOOP_DELAY_MIN_MS 75   // default minimum delay in main loop in milliseconds
+#define MAIN_LOOP_DELAY_MAX_MS 150  // default maximum delay in main loop in milliseconds
+
+// EEPROM address of the config received over the air
+#define EEPROM_CONFIG_ADDRESS 0
+
+
+SensorNode::SensorNode(uint8_t node_id) : RadioNode(node_id) {
+
+    this->classifier.occupied_mm = CLASSIFIER_OCCUPIED_MM;
+    this->classifier.vacant_mm = CLASSIFIER_VACANT_MM;
+    this->classifier.num_agree = CLASSIFIER_NUM_AGREE;
+    this->classifier.num_window = CLASSIFIER_NUM_WINDOW;
+
+    this->heartbeat_interval_ms = HEARTBEAT_INTERVAL_MS;
+
+    this->loop_delay_min_ms = MAIN_LOOP_DELAY_MIN_MS;
+    this->loop_delay_max_ms = MAIN_LOOP_DELAY_MAX_MS;
+    this->channel_checks_max = CHANNEL_CHECKS_MAX;
+
+    for (uint8_t i = 0; i < NUM_NEXT_HOPS; i++) {
+        this->links[i].node_id = NOT_SPOT;
     }
 
-    // generate address as byte array
-    const byte address_bytes[RF24_ADDRESS_WIDTH] = { node_id, node_id, node_id, node_id };
+    // track each unique candidate next node
+    for (uint8_t i = 0; i < NUM_NEXT_HOPS; i++) {
 
-    // convert byte array to 32 bit integer
-    uint32_t address = 0;
-    memcpy(&address, address_bytes, sizeof(address));
-    
-    return address; 
-}
+        int16_t hop_id = get_ingress_node_candidate(node_id, i);
 
+        if (0 <= hop_id && NULL != this->get_link(hop_id)) {
+            hop_id = NOT_SPOT;
+        }
+
+        this->links[i].node_id = hop_id;
+        this->links[i].quality = LINK_QUALITY_INITIAL;
 
-uint8_t SensorNode::calculate_radio_channel(uint8_t node_id) {
+        // start with low transmit power in low power mode
+        this->links[i].pa_level = (true == LOW_POWER_ENABLED) ? RF24_PA_LOW : RF24_PA_MAX;
 
-    return node_id * RF24_CHANNEL_SPACING;
+        // start with full robustness until the link has been measured
+        this->links[i].retries = LINK_RETRIES_INITIAL;
+        this->links[i].retry_delay = FAILED_SEND_DELAY;
+    }
 }
 
 
@@ -85,24 +155,38 @@ bool SensorNode::init() {
         return false;
     }
 
-    // start radio
-    if (false == radio.begin()) {
+#if TOF_CONTINUOUS_ENABLED
+    // let the sensor range on its own so results can be read when ready
+    sensor.startRangeContinuous(constrain(TOF_RANGE_PERIOD_MS, 10, 2550));
+#endif
+
+    // run the config last received over the air
+    ConfigMessage config = ConfigMessage();
+    if (true == SensorNode::load_config(EEPROM_CONFIG_ADDRESS, &config)) {
+        this->config_version = config.get_version();
+        this->set_config(config.get_settings());
+    }
+
+    // start radio and listen for beacons when TDMA is enabled
+    if (false == this->init_radio()) {
 
         ERROR("Failed to start radio")
         return false;
     }
 
-    // configure radio
-    radio.enableDynamicPayloads();
-    radio.setAutoAck(true);
-    radio.setRetries(FAILED_SEND_DELAY, MAX_SEND_ATTEMPTS);
-    radio.setAddressWidth(RF24_ADDRESS_WIDTH);
-    radio.setPALevel(RF24_PA_MAX);
-    radio.setChannel(this->radio_channel);
-    radio.openReadingPipe(RF24_READING_PIPE, this->radio_address);
+#if TDMA_ENABLED
+    this->tdma_slot = get_tdma_slot(this->node_id);
+#endif
+
+    // give each node its own random sequence so heartbeats spread out
+    randomSeed(this->node_id);
+
+    // first heartbeat lands anywhere within one interval of power-up
+    this->status_sent_ms = millis();
+    this->next_heartbeat_ms = this->status_sent_ms + random(this->heartbeat_interval_ms);
 
-    // start listening on radio
-    radio.startListening();
+    // spread the first stats messages the same way
+    this->stats_ms = millis() - random(STATS_INTERVAL_MS);
 
     return true;
 }
@@ -114,41 +198,181 @@ tof_sensor_status_t SensorNode::get_sensor_status() {
 }
 
 
+bool SensorNode::is_sample_due() {
+
+#if LOW_POWER_ENABLED
+    // not time for next sample
+    if (SENSOR_SAMPLE_INTERVAL_MS > (millis() - this->last_sample_ms)) {
+        return false;
+    }
+
+    this->last_sample_ms = millis();
+#endif
+
+    return true;
+}
+
+
+bool SensorNode::set_classifier_config(classifier_config_t config) {
+
+    // thresholds must not overlap and agreeing samples must be a majority of the window
+    if (config.occupied_mm >= config.vacant_mm
+        || (config.num_agree * 2) <= config.num_window
+        || config.num_agree > config.num_window
+        || CLASSIFIER_MAX_WINDOW < config.num_window) {
+
+        return false;
+    }
+
+    this->classifier = config;
+
+    // restart debouncing with the new settings
+    this->sample_history = 0;
+    this->num_samples = 0;
+
+    return true;
+}
+
+
+bool SensorNode::set_heartbeat_interval(uint32_t interval_ms) {
+
+    // jitter must not be able to make the interval negative
+    if (HEARTBEAT_JITTER_MS >= interval_ms) {
+        return false;
+    }
+
+    this->heartbeat_interval_ms = interval_ms;
+    this->schedule_heartbeat();
+
+    return true;
+}
+
+
+bool SensorNode::is_heartbeat_due() {
+
+    return 0 == this->get_time_until_heartbeat();
+}
+
+
+uint32_t SensorNode::get_time_until_heartbeat() {
+
+    uint32_t remaining_ms = this->next_heartbeat_ms - millis();
+
+    // heartbeat time has passed
+    if (remaining_ms > this->heartbeat_interval_ms + HEARTBEAT_JITTER_MS) {
+        return 0;
+    }
+
+    return remaining_ms;
+}
+
+
+void SensorNode::schedule_heartbeat() {
+
+    this->status_sent_ms = millis();
+
+    // spread heartbeats so neighboring nodes do not stay in lockstep
+    this->next_heartbeat_ms = this->status_sent_ms
+                            + (this->heartbeat_interval_ms - HEARTBEAT_JITTER_MS)
+                            + random(2 * HEARTBEAT_JITTER_MS + 1);
+}
+
+
+bool SensorNode::record_sample(uint8_t range_mm, uint8_t status) {
+
+    bool is_occupied = false;
+
+    // sensor saw nothing within range
+    if (VL6180X_ERROR_NOCONVERGE == status) {
+        is_occupied = false;
+    }
+
+    // sensor read error occured
+    else if (VL6180X_ERROR_NONE != status) {
+        return false;
+    }
+
+    // something close enough to be a car
+    else if (this->classifier.occupied_mm >= range_mm) {
+        is_occupied = true;
+    }
+
+    // nothing close enough to be a car
+    else if (this->classifier.vacant_mm <= range_mm) {
+        is_occupied = false;
+    }
+
+    // range is between thresholds so status has not been determined
+    else if (NOT_INITIALIZED == this->sensor_status) {
+        return false;
+    }
+
+    // range is between thresholds so keep current status
+    else {
+        is_occupied = (OCCUPIED == this->sensor_status);
+    }
+
+    this->sample_history = (this->sample_history << 1) | (is_occupied ? 1 : 0);
+
+    if (this->classifier.num_window > this->num_samples) {
+        this->num_samples++;
+    }
+
+    return true;
+}
+
+
 bool SensorNode::is_sensor_status_changed() {
 
+#if TOF_CONTINUOUS_ENABLED
+    // no new range from sensor yet
+    if (false == this->sensor.isRangeComplete()) {
+        return false;
+    }
+
     // get range from sensor
-    (void) this->sensor.readRange();
+    uint8_t range_mm = this->sensor.readRangeResult();
+#else
+    // get range from sensor
+    uint8_t range_mm = this->sensor.readRange();
+#endif
+
     uint8_t status = this->sensor.readRangeStatus();
 
-    // sensor read occupied
-    if (VL6180X_ERROR_NONE == status) {
+    // sensor error occured
+    if (false == this->record_sample(range_mm, status)) {
+        WARN("ToF sensor read error");
+        return false;
+    }
 
-        // status of parking spot did not change
-        if (OCCUPIED == this->sensor_status) {
-            return false;
-        }
+    // not enough samples to determine status
+    if (this->classifier.num_agree > this->num_samples) {
+        return false;
+    }
+
+    // count occupied samples within the window
+    uint8_t window_mask = (1 << this->num_samples) - 1;
+    uint8_t num_occupied = __builtin_popcount(this->sample_history & window_mask);
+    uint8_t num_vacant = this->num_samples - num_occupied;
+
+    // enough samples read occupied
+    if (OCCUPIED != this->sensor_status && this->classifier.num_agree <= num_occupied) {
 
         // status of parking space changed
         INFO("parking space is now occupied")
         this->sensor_status = OCCUPIED;
     }
 
-    // sensor read vacant
-    else if (VL6180X_ERROR_NOCONVERGE == status) {
-        
-        // status of parking spot did not change
-        if (VACANT == this->sensor_status) {
-            return false;
-        }
+    // enough samples read vacant
+    else if (VACANT != this->sensor_status && this->classifier.num_agree <= num_vacant) {
 
         // status of parking space changed
         INFO("parking space is now vacant")
         this->sensor_status = VACANT;
     }
 
-    // sensor error occured
+    // status of parking spot did not change
     else {
-        WARN("ToF sensor read error");
         return false;
     }
 
@@ -156,19 +380,218 @@ bool SensorNode::is_sensor_status_changed() {
 }
 
 
-bool SensorNode::transmit_update(UpdateMessage* msg) {
+link_t* SensorNode::get_link(uint8_t node_id) {
+
+    for (uint8_t i = 0; i < NUM_NEXT_HOPS; i++) {
+
+        if (node_id == this->links[i].node_id) {
+            return &this->links[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+void SensorNode::update_link_quality(uint8_t node_id, bool is_sent) {
+
+    link_t* link = this->get_link(node_id);
+
+    // not a tracked link
+    if (NULL == link) {
+        return;
+    }
+
+    // move quality toward full on success and toward zero on failure
+    int16_t target = (true == is_sent) ? UINT8_MAX : 0;
+    int16_t quality = link->quality;
+    quality += (target - quality) >> LINK_QUALITY_WEIGHT_SHIFT;
+    link->quality = (uint8_t)quality;
+
+#if LOW_POWER_ENABLED
+    // raise transmit power when the link fails
+    if (false == is_sent && this->max_pa_level > link->pa_level) {
+        link->pa_level++;
+    }
+
+    // lower transmit power once the link is consistently strong
+    else if (true == is_sent && LINK_QUALITY_STRONG <= link->quality && RF24_PA_MIN < link->pa_level) {
+        link->pa_level--;
+        link->quality = LINK_QUALITY_INITIAL;
+    }
+#endif
+}
+
+
+void SensorNode::tune_link(link_t* link, bool is_sent, uint8_t num_retries) {
+
+    // fall back to the configured settings until the link proves itself again
+    if (false == is_sent) {
+        link->retries = LINK_RETRIES_INITIAL;
+        link->retry_delay = this->failed_send_delay;
+        return;
+    }
+
+    // move the average retries toward those the message needed
+    int16_t target = (int16_t)num_retries << 4;
+    int16_t retries = link->retries;
+    retries += (target - retries) >> LINK_RETRIES_WEIGHT_SHIFT;
+    link->retries = (uint8_t)retries;
+
+    // acknowledged first time so retransmissions can come sooner
+    if (0 == num_retries && LINK_RETRY_DELAY_MIN < link->retry_delay) {
+        link->retry_delay--;
+    }
+
+    // receiver needed time to answer so wait longer between retransmissions
+    else if (LINK_RETRIES_SLOW <= num_retries && this->failed_send_delay > link->retry_delay) {
+        link->retry_delay++;
+    }
+}
+
+
+int16_t SensorNode::get_alternate_hop(uint8_t node_id) {
+
+    for (uint8_t i = 0; i < NUM_NEXT_HOPS; i++) {
+
+        if (0 <= this->links[i].node_id && node_id != this->links[i].node_id) {
+            return this->links[i].node_id;
+        }
+    }
+
+    return NOT_SPOT;
+}
+
+
+int16_t SensorNode::get_next_hop() {
+
+    link_t* best = NULL;
+    link_t* other = NULL;
+
+    // rank the candidate next nodes by their delivery history
+    for (uint8_t i = 0; i < NUM_NEXT_HOPS; i++) {
+
+        link_t* link = &this->links[i];
+
+        if (0 > link->node_id) {
+            continue;
+        }
+
+        if (NULL == best || link->quality > best->quality) {
+            other = best;
+            best = link;
+        }
+
+        else if (NULL == other) {
+            other = link;
+        }
+    }
+
+    // no next node
+    if (NULL == best) {
+        return NOT_SPOT;
+    }
+
+    // only one next node
+    if (NULL == other) {
+        return best->node_id;
+    }
+
+    // links are equivalent so spread the traffic between them
+    if (LINK_QUALITY_MARGIN > (best->quality - other->quality)) {
+        return (0 == (random() % 2)) ? best->node_id : other->node_id;
+    }
+
+    // occasionally probe the less preferred link
+    if (0 == (random() % LINK_PROBE_ODDS)) {
+        return other->node_id;
+    }
+
+    return best->node_id;
+}
+
+
+bool SensorNode::transmit_message(Message* msg, uint8_t size) {
+
+    uint8_t rx_id = msg->get_rx_id();
+    int16_t alternate_id = this->get_alternate_hop(rx_id);
+    link_t* link = this->get_link(rx_id);
+
+    // do not waste retries on an unhealthy link when there is an alternate
+    uint8_t max_attempts = this->max_send_attempts;
+    if (0 <= alternate_id && NULL != link && LINK_QUALITY_HEALTHY > link->quality) {
+        max_attempts = min(max_attempts, (uint8_t)PROBE_SEND_ATTEMPTS);
+    }
+
+    bool is_sent = this->transmit_attempt(msg, size, max_attempts);
+    this->update_link_quality(rx_id, is_sent);
+
+    // retry once through the alternate next node
+    if (false == is_sent && NULL != link && 0 <= alternate_id) {
+
+        WARN("Failed to transmit to Node %d. Retrying via Node %d", rx_id, alternate_id)
+
+        msg->set_rx_id((uint8_t)alternate_id);
+        is_sent = this->transmit_attempt(msg, size, this->max_send_attempts);
+        this->update_link_quality(alternate_id, is_sent);
+    }
+
+    if (false == is_sent) {
+        COUNTER_INC(COUNTER_DROPS);
+    }
+
+    // a next node heard the node on its new radio settings
+    if (true == is_sent) {
+        this->confirm_radio_settings();
+    }
+
+    // nothing got through on the new radio settings, so go back to the old ones
+    else if (true == this->is_radio_fallback_due()) {
+        WARN("No node acknowledged new radio settings. Reverted to config version %d", this->fallback_version)
+        this->fall_back_radio_settings();
+        this->store_settings();
+    }
+
+    return is_sent;
+}
+
+
+bool SensorNode::transmit_attempt(Message* msg, uint8_t size, uint8_t max_attempts) {
+
+    COUNTER_INC(COUNTER_TX_ATTEMPTS);
+
+#if RF24_IRQ_ENABLED
+    this->begin_radio_access();
+#endif
+
+#if LOW_POWER_ENABLED
+    // radio must be powered to transmit
+    if (false == this->is_radio_on) {
+        this->radio.powerUp();
+        this->is_radio_on = true;
+    }
+#endif
 
     // calculate receiver node's radio configuration
     uint8_t rx_id = msg->get_rx_id();
-    uint32_t rx_address = this->calculate_radio_address(rx_id);
+    uint32_t rx_address = this->calculate_tx_address(rx_id);
     uint8_t rx_channel = this->calculate_radio_channel(rx_id);
 
-    // switch to receiver node's channel
-    this->radio.setChannel(rx_channel);
+    // switch to receiver node's channel if it is not shared
+    bool is_shared_channel = (rx_channel == this->radio_channel);
+    if (false == is_shared_channel) {
+        this->radio.setChannel(rx_channel);
+    }
 
     // wait for there to be no traffic on receiver's channel or timeout occurs
     bool is_channel_open = false;
-    for (uint8_t i = 0; i < CHANNEL_CHECKS_MAX; i++) {
+
+    // channel belongs to this node during its slot
+    if (true == this->is_synchronized()) {
+        is_channel_open = true;
+    }
+
+    for (uint8_t i = 0; i < this->channel_checks_max && false == is_channel_open; i++) {
 
         // check if channel is open
         is_channel_open = (false == this->radio.testCarrier());
@@ -178,9 +601,12 @@ bool SensorNode::transmit_update(UpdateMessage* msg) {
             break;
         }
 
+        COUNTER_INC(COUNTER_CARRIER_BUSY);
+
         // delay a random amount of time to avoid collisions
         uint32_t channel_delay = random(CHANNEL_BUSY_DELAY_MIN_MS, CHANNEL_BUSY_DELAY_MAX_MS);
-        INFO("Channel " + rx_channel + " is busy. Waiting " + channel_delay + " ms")
+        COUNTER_ADD(COUNTER_BACKOFF_MS, channel_delay);
+        INFO("Channel %d is busy. Waiting %lu ms", rx_channel, channel_delay)
         delay(channel_delay);
     }
 
@@ -188,66 +614,961 @@ bool SensorNode::transmit_update(UpdateMessage* msg) {
     if (false == is_channel_open) {
 
         // switch back to this node's radio configuration
-        this->radio.setChannel(this->radio_channel);
-        radio.openReadingPipe(RF24_READING_PIPE, this->radio_address);
+        if (false == is_shared_channel) {
+            this->radio.setChannel(this->radio_channel);
+            this->open_reading_pipes();
+        }
+
+#if RF24_IRQ_ENABLED
+        this->end_radio_access();
+#endif
 
+        COUNTER_INC(COUNTER_TX_FAILURES);
         return false;
     }
 
-    // stop listening
+    // stop listening and only give up this node's pipes when leaving its channel
     this->radio.stopListening();
-    this->radio.closeReadingPipe(RF24_READING_PIPE);
+    if (false == is_shared_channel) {
+        this->close_reading_pipes();
+    }
+
+    link_t* link = this->get_link(rx_id);
+    uint8_t retry_delay = this->failed_send_delay;
+
+#if LINK_TUNING_ENABLED
+    // only allow the retries the link has recently needed, with a margin
+    if (NULL != link) {
+        retry_delay = min(link->retry_delay, this->failed_send_delay);
+        max_attempts = min(max_attempts, (uint8_t)((link->retries >> 3) + LINK_RETRIES_MARGIN));
+    }
+#endif
 
     // create pipe to receiver node
     radio.openWritingPipe(rx_address);
+    radio.setRetries(retry_delay, max_attempts);
 
-    // create a copy of the message to send
-    uint8_t buffer[sizeof(*msg)];
-    memcpy(buffer, msg, sizeof(buffer));
+    // use the transmit power chosen for the link without going over the configured level
+    radio.setPALevel((NULL != link) ? min(link->pa_level, this->max_pa_level) : this->max_pa_level);
 
     // attempt to transmit message
-    bool is_sent = this->radio.write(&buffer, sizeof(buffer));
+    size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+#if LOW_POWER_ENABLED
+    uint32_t write_ms = millis();
+#endif
+    bool is_sent = this->radio.write(msg, size);
+
+#if LOW_POWER_ENABLED
+    // retry across a full listen cycle so the receiver's listen window is hit
+    for (uint8_t i = 0; i < LISTEN_RETRIES_MAX && false == is_sent; i++) {
+
+        // sleep with the radio off until the next retry is due
+        uint32_t elapsed_ms = millis() - write_ms;
+        this->radio.powerDown();
+        if (LISTEN_RETRY_INTERVAL_MS > elapsed_ms) {
+            (void) low_power_sleep(LISTEN_RETRY_INTERVAL_MS - elapsed_ms);
+        }
+
+        this->radio.powerUp();
+        write_ms = millis();
+        is_sent = this->radio.write(msg, size);
+    }
+#endif
+
+    // retransmissions the radio made for the last write
+    uint8_t num_retries = this->radio.getARC();
+    if (true == is_sent) {
+        COUNTER_ADD(COUNTER_RETRIES, num_retries);
+    }
+
+#if LINK_TUNING_ENABLED
+    if (NULL != link) {
+        this->tune_link(link, is_sent, num_retries);
+    }
+#else
+    (void) num_retries;
+#endif
 
     // switch back to this node's radio configuration
-    this->radio.setChannel(this->radio_channel);
-    radio.openReadingPipe(RF24_READING_PIPE, this->radio_address);
+    if (false == is_shared_channel) {
+        this->radio.setChannel(this->radio_channel);
+        this->open_reading_pipes();
+    }
 
     // start listening again
     this->radio.startListening();
 
+#if LOW_POWER_ENABLED
+    // listening powers up the radio
+    this->is_radio_on = true;
+#endif
+
+#if RF24_IRQ_ENABLED
+    this->end_radio_access();
+#endif
+
+    if (false == is_sent) {
+        COUNTER_INC(COUNTER_TX_FAILURES);
+    }
+
     return is_sent;
 }
 
 
+bool SensorNode::transmit_update(UpdateMessage* msg) {
+
+    return this->transmit_message(msg, sizeof(*msg));
+}
+
+
 bool SensorNode::transmit_update(uint8_t rx_node_id) {
 
-    // create update message
     bool is_vacant = (this->sensor_status == VACANT);
-    UpdateMessage msg = UpdateMessage(rx_node_id, this->node_id, this->node_id, is_vacant);
+
+    // piggyback status onto pending updates if there are any
+    if (0 < this->pending_updates.get_num_entries() && true == this->queue_status()) {
+        return this->transmit_pending_updates(rx_node_id);
+    }
+
+    // status is going out so the next heartbeat can wait a full interval
+    this->schedule_heartbeat();
+
+    // create update message
+    UpdateMessage msg = UpdateMessage(rx_node_id, this->node_id, this->node_id, is_vacant, this->next_sequence());
 
     // attempt to transmit message
-    return this->transmit_update(&msg);
+    bool is_sent = this->transmit_update(&msg);
+    this->forward_trace(&msg, is_sent);
+
+    return is_sent;
 }
 
 
-bool SensorNode::is_message() {
+bool SensorNode::transmit_update(AggregateMessage* msg) {
 
-    return this->radio.available();
+    return this->transmit_message(msg, msg->get_size());
 }
 
 
-bool SensorNode::read_message(uint8_t** buffer, uint8_t len) {
+bool SensorNode::queue_update(uint8_t node_id, bool is_vacant, uint8_t sequence) {
 
-    if (false == this->radio.available()) {
+    bool is_own_status = (this->node_id == node_id);
+
+    // status was already forwarded or is older than one that was
+    if (false == is_own_status && false == this->seen_sequences.is_new(node_id, sequence)) {
+        INFO("Dropped duplicate status of Node %d", node_id)
+        return true;
+    }
+
+    // start aggregation window with first pending update
+    if (0 == this->pending_updates.get_num_entries()) {
+        this->pending_updates_ms = millis();
+    }
+
+    if (false == this->pending_updates.add_entry(node_id, is_vacant, sequence)) {
+        COUNTER_INC(COUNTER_DROPS);
         return false;
     }
 
-    this->radio.read(buffer, len);
+    // only mark the status seen once it is queued, so a retry of a dropped
+    // status is still forwarded
+    if (false == is_own_status) {
+        (void) this->seen_sequences.accept(node_id, sequence);
+    }
+
     return true;
 }
 
 
-uint8_t SensorNode::get_id() {
+bool SensorNode::queue_status() {
+
+    // status will go out with the pending updates
+    this->schedule_heartbeat();
+
+    return this->queue_update(this->node_id, VACANT == this->sensor_status, this->next_sequence());
+}
+
+
+uint8_t SensorNode::next_sequence() {
+
+    uint8_t sequence = this->status_sequence;
+    this->status_sequence = sequence_next(sequence);
+
+    return sequence;
+}
+
 
-    return this->node_id;
+bool SensorNode::queue_update(AggregateMessage* msg) {
+
+    bool is_queued = true;
+
+    for (uint8_t i = 0; i < msg->get_num_entries(); i++) {
+
+        if (false == this->queue_update(msg->get_node_id(i), msg->get_is_vacant(i), msg->get_sequence(i))) {
+            is_queued = false;
+        }
+    }
+
+    return is_queued;
+}
+
+
+bool SensorNode::is_pending_update_ready() {
+
+    // nothing to forward
+    if (0 == this->pending_updates.get_num_entries()) {
+        return false;
+    }
+
+    // pending updates go out in the node's slot
+    if (true == this->is_synchronized()) {
+        return this->is_transmit_slot();
+    }
+
+    // no room left to aggregate more updates
+    if (true == this->pending_updates.is_full()) {
+        return true;
+    }
+
+    return AGGREGATE_WINDOW_MS <= (millis() - this->pending_updates_ms);
+}
+
+
+bool SensorNode::transmit_broadcast(Message* msg, uint8_t size) {
+
+#if RF24_IRQ_ENABLED
+    this->begin_radio_access();
+#endif
+
+    this->radio.stopListening();
+    this->radio.openWritingPipe(BROADCAST_ADDRESS);
+
+    // attempt to transmit message without waiting for an acknowledgement
+    size = min(size, (uint8_t)MESSAGE_MAX_SIZE);
+    bool is_sent = this->radio.write(msg, size, true);
+
+    // start listening again
+    this->radio.startListening();
+
+#if LOW_POWER_ENABLED
+    // listening powers up the radio
+    this->is_radio_on = true;
+#endif
+
+#if RF24_IRQ_ENABLED
+    this->end_radio_access();
+#endif
+
+    return is_sent;
+}
+
+
+#if TDMA_ENABLED
+uint32_t SensorNode::get_superframe_offset_ms() {
+
+    uint16_t superframe_ms = this->beacon.get_superframe_ms();
+
+    // invalid superframe
+    if (0 == superframe_ms) {
+        return 0;
+    }
+
+    return (millis() - this->superframe_start_ms) % superframe_ms;
+}
+#endif
+
+
+bool SensorNode::synchronize(BeaconMessage* msg) {
+
+#if TDMA_ENABLED
+    // already synchronized to this beacon
+    if (true == this->is_beacon_received && msg->get_sequence() == this->beacon.get_sequence()) {
+        return false;
+    }
+
+    // beacon describes an invalid superframe
+    if (0 == msg->get_superframe_ms()) {
+        return false;
+    }
+
+    // align superframe to when the sender says it started
+    this->beacon_ms = millis();
+    this->superframe_start_ms = this->beacon_ms - msg->get_offset_ms();
+    this->beacon = *msg;
+    this->is_beacon_received = true;
+
+    return true;
+#else
+    (void) msg;
+    return false;
+#endif
+}
+
+
+bool SensorNode::transmit_beacon() {
+
+#if TDMA_ENABLED
+    if (false == this->is_beacon_received) {
+        return false;
+    }
+
+    // spread out relays from neighboring nodes
+    delay(random(0, BEACON_JITTER_MS + 1));
+
+    // beacon phase is over so nodes farther away would be misaligned
+    uint32_t offset_ms = this->get_superframe_offset_ms();
+    if (this->beacon.get_phase_ms() <= offset_ms) {
+        return false;
+    }
+
+    BeaconMessage msg = BeaconMessage(this->node_id,
+                                      this->beacon.get_sequence(),
+                                      this->beacon.get_phase_ms(),
+                                      this->beacon.get_slot_ms(),
+                                      this->beacon.get_num_slots(),
+                                      (uint8_t)offset_ms);
+
+    return this->transmit_broadcast(&msg, sizeof(msg));
+#else
+    return false;
+#endif
+}
+
+
+bool SensorNode::is_synchronized() {
+
+#if TDMA_ENABLED
+    // node has no slot in the superframe
+    if (0 > this->tdma_slot || this->beacon.get_num_slots() <= this->tdma_slot) {
+        return false;
+    }
+
+    // beacons stopped arriving
+    uint32_t timeout_ms = (uint32_t)BEACON_MISSES_MAX * this->beacon.get_superframe_ms();
+    return true == this->is_beacon_received && timeout_ms > (millis() - this->beacon_ms);
+#else
+    return false;
+#endif
+}
+
+
+bool SensorNode::is_transmit_slot() {
+
+    return 0 == this->get_time_until_slot();
+}
+
+
+uint32_t SensorNode::get_time_until_slot() {
+
+#if TDMA_ENABLED
+    // transmit whenever without a schedule
+    if (false == this->is_synchronized()) {
+        return 0;
+    }
+
+    uint32_t offset_ms = this->get_superframe_offset_ms();
+    uint32_t slot_start_ms = this->beacon.get_phase_ms() + ((uint32_t)this->tdma_slot * this->beacon.get_slot_ms());
+    uint32_t slot_end_ms = slot_start_ms + this->beacon.get_slot_ms() - TDMA_GUARD_MS;
+
+    // slot has not started yet this superframe
+    if (slot_start_ms > offset_ms) {
+        return slot_start_ms - offset_ms;
+    }
+
+    // currently in slot
+    if (slot_end_ms > offset_ms) {
+        return 0;
+    }
+
+    // wait for slot in the next superframe
+    return this->beacon.get_superframe_ms() - offset_ms + slot_start_ms;
+#else
+    return 0;
+#endif
+}
+
+
+bool SensorNode::transmit_pending_updates(uint8_t rx_node_id) {
+
+    // piggyback own status on relayed traffic once half a heartbeat interval has passed
+    if ((this->heartbeat_interval_ms / 2) <= (millis() - this->status_sent_ms)) {
+        (void) this->queue_status();
+    }
+
+    // create aggregate message from pending updates
+    AggregateMessage msg = AggregateMessage(rx_node_id, this->node_id);
+    (void) msg.merge(&this->pending_updates);
+
+    this->pending_updates.clear();
+    COUNTER_INC(COUNTER_FORWARDS);
+
+    // attempt to transmit message
+    bool is_sent = this->transmit_update(&msg);
+    this->forward_trace(&msg, is_sent);
+
+    return is_sent;
+}
+
+
+void SensorNode::start_trace() {
+
+#if TRACE_ENABLED
+    // the next sequence number goes to the status being traced
+    this->pending_trace = TraceMessage(BASE_STATION_ID, this->node_id, this->node_id, this->status_sequence);
+    this->is_trace_pending = true;
+    this->trace_ms = millis();
+#endif
+}
+
+
+bool SensorNode::queue_trace(TraceMessage* msg) {
+
+    // only one trace message is held at a time
+    if (true == this->is_trace_pending) {
+        return false;
+    }
+
+    // this node becomes the transmitter
+    this->pending_trace = TraceMessage(BASE_STATION_ID, this->node_id, msg->get_origin_id(), msg->get_sequence());
+
+    for (uint8_t i = 0; i < msg->get_num_hops(); i++) {
+        (void) this->pending_trace.add_hop(msg->get_hop_node_id(i), msg->get_hop_delay_ms(i));
+    }
+
+    this->is_trace_pending = true;
+    this->trace_ms = millis();
+
+    return true;
+}
+
+
+bool SensorNode::is_trace_ready() {
+
+    // nothing to send or the status it follows has not been sent yet
+    if (false == this->is_trace_pending || 0 < this->pending_updates.get_num_entries()) {
+        return false;
+    }
+
+    // traces go out in the node's slot
+    if (true == this->is_synchronized()) {
+        return this->is_transmit_slot();
+    }
+
+    return true;
+}
+
+
+bool SensorNode::transmit_trace(uint8_t rx_node_id) {
+
+    this->is_trace_pending = false;
+
+    // includes the time spent backing off and retrying the status itself
+    if (false == this->pending_trace.add_hop(this->node_id, millis() - this->trace_ms)) {
+        WARN("Trace of Node %d has too many hops", this->pending_trace.get_origin_id())
+    }
+
+    this->pending_trace.set_rx_id(rx_node_id);
+
+    return this->transmit_message(&this->pending_trace, this->pending_trace.get_size());
+}
+
+
+void SensorNode::forward_trace(Message* msg, bool is_sent) {
+
+    // nothing to trace
+    if (false == this->is_trace_pending) {
+        return;
+    }
+
+    // status was lost so the trace is meaningless
+    if (false == is_sent) {
+        this->is_trace_pending = false;
+        return;
+    }
+
+    // follow the same route as the status, including any failover
+    (void) this->transmit_trace(msg->get_rx_id());
+}
+
+
+bool SensorNode::queue_query(QueryMessage* msg) {
+
+    bool is_answered = false;
+
+    // report the node's status unless the sensor has not been read yet,
+    // in which case its first reading is sent regardless
+    if (true == msg->get_is_queried(this->node_id) && NOT_INITIALIZED != this->sensor_status) {
+        is_answered = this->queue_status();
+    }
+
+    // cover every node so queries from any sender can be merged
+    if (false == this->is_query_pending) {
+        this->pending_query = QueryMessage(this->node_id, this->node_id, 1, LAYOUT_MAX_NODE_ID);
+    }
+
+    for (uint8_t i = 0; i < msg->get_num_nodes(); i++) {
+
+        uint8_t target_id = msg->get_first_node_id() + i;
+
+        // only forward to nodes whose route passes through this node
+        if (this->node_id == target_id
+            || false == msg->get_is_queried(target_id)
+            || 0 > get_next_egress_node(this->node_id, target_id)) {
+
+            continue;
+        }
+
+        if (true == this->pending_query.set_is_queried(target_id, true)) {
+            this->is_query_pending = true;
+        }
+    }
+
+    return true == is_answered || true == this->is_query_pending;
+}
+
+
+bool SensorNode::is_query_ready() {
+
+    // nothing to forward
+    if (false == this->is_query_pending) {
+        return false;
+    }
+
+    // queries go out in the node's slot
+    if (true == this->is_synchronized()) {
+        return this->is_transmit_slot();
+    }
+
+    return true;
+}
+
+
+bool SensorNode::transmit_query() {
+
+    int16_t rx_id = NOT_SPOT;
+    QueryMessage msg = QueryMessage();
+
+    // gather every held target sharing the next node of the first one
+    for (uint8_t target_id = 1; target_id <= LAYOUT_MAX_NODE_ID; target_id++) {
+
+        if (false == this->pending_query.get_is_queried(target_id)) {
+            continue;
+        }
+
+        int16_t hop = get_next_egress_node(this->node_id, target_id);
+
+        // target can no longer be routed
+        if (0 > hop) {
+            (void) this->pending_query.set_is_queried(target_id, false);
+            continue;
+        }
+
+        if (0 > rx_id) {
+            rx_id = hop;
+            msg = QueryMessage((uint8_t)rx_id, this->node_id, 1, LAYOUT_MAX_NODE_ID);
+        }
+
+        if (rx_id == hop) {
+            (void) msg.set_is_queried(target_id, true);
+            (void) this->pending_query.set_is_queried(target_id, false);
+        }
+    }
+
+    this->is_query_pending = (false == this->pending_query.is_empty());
+
+    // no held target could be routed
+    if (0 > rx_id) {
+        this->is_query_pending = false;
+        return false;
+    }
+
+    COUNTER_INC(COUNTER_FORWARDS);
+
+    return this->transmit_message(&msg, msg.get_size());
+}
+
+
+void SensorNode::set_config(config_settings_t settings) {
+
+    this->set_radio_settings(settings);
+
+    // only sensor nodes in the layout can be taken over
+    if (CONFIG_KEEP != settings.node_id
+        && LAYOUT_NONE != layout_read_grid_cell(settings.node_id)
+        && false == layout_read_is_sink(settings.node_id)) {
+
+        this->configured_id = settings.node_id;
+    }
+
+    uint8_t min_ms = (CONFIG_KEEP == settings.loop_delay_min_ms) ? this->loop_delay_min_ms : settings.loop_delay_min_ms;
+    uint8_t max_ms = (CONFIG_KEEP == settings.loop_delay_max_ms) ? this->loop_delay_max_ms : settings.loop_delay_max_ms;
+
+    // range must not be empty
+    if (min_ms < max_ms) {
+        this->loop_delay_min_ms = min_ms;
+        this->loop_delay_max_ms = max_ms;
+    }
+
+    if (CONFIG_KEEP != settings.heartbeat_interval_s) {
+        (void) this->set_heartbeat_interval(settings.heartbeat_interval_s * 1000UL);
+    }
+
+    if (CONFIG_KEEP != settings.channel_checks_max) {
+        this->channel_checks_max = settings.channel_checks_max;
+    }
+}
+
+
+void SensorNode::apply_config(ConfigMessage* msg, bool is_radio_switched) {
+
+    config_settings_t settings = msg->get_settings();
+
+    // stay reachable by the nodes that missed it
+    if (false == is_radio_switched) {
+
+        WARN("Config version %d did not reach every next node. Keeping radio settings", msg->get_version())
+
+        settings.pa_level = CONFIG_KEEP;
+        settings.data_rate = CONFIG_KEEP;
+    }
+
+    this->switch_radio_settings(settings, msg->get_version());
+    this->set_config(settings);
+    this->store_settings();
+
+    INFO("Applied config version %d", this->config_version)
+
+    if (CONFIG_KEEP != this->configured_id && this->node_id != this->configured_id) {
+        INFO("Node becomes Node %d on restart", this->configured_id)
+    }
+}
+
+
+void SensorNode::store_settings() {
+
+    // store every current setting so a later partial config keeps the others
+    config_settings_t settings;
+    settings.node_id = this->configured_id;
+    settings.loop_delay_min_ms = this->loop_delay_min_ms;
+    settings.loop_delay_max_ms = this->loop_delay_max_ms;
+    settings.heartbeat_interval_s = min(this->heartbeat_interval_ms / 1000, (uint32_t)(CONFIG_KEEP - 1));
+    settings.max_send_attempts = this->max_send_attempts;
+    settings.failed_send_delay = this->failed_send_delay;
+    settings.channel_checks_max = this->channel_checks_max;
+    settings.pa_level = this->max_pa_level;
+    settings.data_rate = this->data_rate;
+
+    ConfigMessage record = ConfigMessage(this->node_id, this->node_id, this->node_id, this->config_version, settings);
+    SensorNode::store_config(EEPROM_CONFIG_ADDRESS, &record);
+}
+
+
+bool SensorNode::queue_config(ConfigMessage* msg) {
+
+    bool is_target = msg->is_target(this->node_id);
+
+    // already running this config, which also stops it circulating
+    if (true == is_target && this->config_version == msg->get_version()) {
+        return false;
+    }
+
+    this->pending_config = *msg;
+    memset(this->config_hops, 0, sizeof(this->config_hops));
+    this->is_config_pending = is_target;
+
+    // first round goes out right away
+    this->config_hop_index = 0;
+    this->num_config_attempts = 0;
+    this->config_ms = millis() - CONFIG_RETRY_MS;
+
+    // pass it to every node whose route to the target passes through this node
+    for (uint8_t target_id = 1; target_id <= LAYOUT_MAX_NODE_ID; target_id++) {
+
+        if (this->node_id == target_id || false == msg->is_target(target_id)) {
+            continue;
+        }
+
+        int16_t hop = get_next_egress_node(this->node_id, target_id);
+
+        if (0 <= hop) {
+            bitmap_set(this->config_hops, hop, true);
+            this->is_config_pending = true;
+        }
+    }
+
+    return this->is_config_pending;
+}
+
+
+bool SensorNode::is_config_ready() {
+
+    // nothing to pass on or apply
+    if (false == this->is_config_pending) {
+        return false;
+    }
+
+    // next nodes that missed it are sent it again once a round has passed
+    if (0 == this->config_hop_index && CONFIG_RETRY_MS > (millis() - this->config_ms)) {
+        return false;
+    }
+
+    // configs go out in the node's slot
+    if (true == this->is_synchronized()) {
+        return this->is_transmit_slot();
+    }
+
+    return true;
+}
+
+
+bool SensorNode::transmit_config() {
+
+    // one next node that has not acknowledged it yet per call
+    for (uint8_t hop = this->config_hop_index; hop <= LAYOUT_MAX_NODE_ID; hop++) {
+
+        if (false == bitmap_get(this->config_hops, hop)) {
+            continue;
+        }
+
+        this->config_hop_index = hop + 1;
+
+        ConfigMessage msg = ConfigMessage(hop,
+                                          this->node_id,
+                                          this->pending_config.get_target_id(),
+                                          this->pending_config.get_version(),
+                                          this->pending_config.get_settings());
+
+        COUNTER_INC(COUNTER_FORWARDS);
+
+        bool is_sent = this->transmit_message(&msg, sizeof(msg));
+
+        // next node may have got it another way and switched already
+        if (false == is_sent && true == this->try_radio_settings(msg.get_settings())) {
+
+            msg.set_rx_id(hop);
+            is_sent = this->transmit_attempt(&msg, sizeof(msg), this->max_send_attempts);
+            this->apply_radio_settings();
+        }
+
+        if (true == is_sent) {
+            bitmap_set(this->config_hops, hop, false);
+        }
+
+        return is_sent;
+    }
+
+    // round over the next nodes is done
+    this->config_hop_index = 0;
+    this->num_config_attempts++;
+    this->config_ms = millis();
+
+    bool is_received = (0 == bitmap_count(this->config_hops, LAYOUT_MAX_NODE_ID + 1));
+
+    // retry the next nodes that missed it
+    if (false == is_received && CONFIG_MAX_ATTEMPTS > this->num_config_attempts) {
+        return true;
+    }
+
+    this->is_config_pending = false;
+
+    // every node farther away has it so the node can switch over
+    if (true == this->pending_config.is_target(this->node_id)) {
+        this->apply_config(&this->pending_config, is_received);
+    }
+
+    return is_received;
+}
+
+
+uint32_t SensorNode::get_loop_delay_ms() {
+
+    return random(this->loop_delay_min_ms, this->loop_delay_max_ms);
+}
+
+
+uint8_t SensorNode::get_configured_id(uint8_t node_id) {
+
+    ConfigMessage config = ConfigMessage();
+
+    // nothing was configured
+    if (false == SensorNode::load_config(EEPROM_CONFIG_ADDRESS, &config)
+        || CONFIG_KEEP == config.get_settings().node_id) {
+
+        return node_id;
+    }
+
+    return config.get_settings().node_id;
+}
+
+
+bool SensorNode::queue_stats(StatsMessage* msg) {
+
+    // only one stats message is held at a time
+    if (true == this->is_stats_pending) {
+        COUNTER_INC(COUNTER_DROPS);
+        return false;
+    }
+
+    uint16_t values[STATS_MAX_COUNTERS];
+
+    for (uint8_t i = 0; i < msg->get_num_counters(); i++) {
+        values[i] = msg->get_counter(i);
+    }
+
+    // this node becomes the transmitter
+    this->pending_stats = StatsMessage(BASE_STATION_ID, this->node_id, msg->get_node_id(), values, msg->get_num_counters());
+    this->is_stats_pending = true;
+
+    return true;
+}
+
+
+bool SensorNode::is_stats_ready() {
+
+    // queue the node's own counters once the interval passes
+    if (false == this->is_stats_pending && STATS_INTERVAL_MS <= (millis() - this->stats_ms)) {
+
+        uint16_t values[NUM_COUNTERS];
+        counters_snapshot(values);
+
+        this->pending_stats = StatsMessage(BASE_STATION_ID, this->node_id, this->node_id, values, NUM_COUNTERS);
+        this->is_stats_pending = true;
+        this->stats_ms = millis();
+    }
+
+    // nothing to send
+    if (false == this->is_stats_pending) {
+        return false;
+    }
+
+    // stats go out in the node's slot
+    if (true == this->is_synchronized()) {
+        return this->is_transmit_slot();
+    }
+
+    return true;
+}
+
+
+bool SensorNode::transmit_stats(uint8_t rx_node_id) {
+
+    this->is_stats_pending = false;
+
+    // stats of other nodes are being forwarded
+    if (this->node_id != this->pending_stats.get_node_id()) {
+        COUNTER_INC(COUNTER_FORWARDS);
+    }
+
+    this->pending_stats.set_rx_id(rx_node_id);
+
+    return this->transmit_message(&this->pending_stats, this->pending_stats.get_size());
+}
+
+
+void SensorNode::idle(uint32_t timeout_ms) {
+
+#if LOW_POWER_ENABLED
+    uint32_t now_ms = millis();
+
+    // start a new listen cycle
+    if (LISTEN_PERIOD_MS <= (now_ms - this->listen_cycle_ms)) {
+
+        if (false == this->is_radio_on) {
+
+#if RF24_IRQ_ENABLED
+            this->begin_radio_access();
+#endif
+            this->radio.powerUp();
+            this->radio.startListening();
+            this->is_radio_on = true;
+#if RF24_IRQ_ENABLED
+            this->end_radio_access();
+#endif
+        }
+
+        this->listen_cycle_ms = now_ms;
+    }
+
+    uint32_t cycle_ms = now_ms - this->listen_cycle_ms;
+    bool is_listening = LISTEN_WINDOW_MS > cycle_ms;
+    uint32_t duration_ms = 0;
+
+    // stay awake for messages until end of listen window
+    if (true == is_listening) {
+        duration_ms = LISTEN_WINDOW_MS - cycle_ms;
+    }
+
+    // power down radio until next listen cycle
+    else {
+
+        if (true == this->is_radio_on) {
+
+#if RF24_IRQ_ENABLED
+            this->begin_radio_access();
+#endif
+            this->radio.powerDown();
+            this->is_radio_on = false;
+#if RF24_IRQ_ENABLED
+            this->end_radio_access();
+#endif
+        }
+
+        duration_ms = LISTEN_PERIOD_MS - cycle_ms;
+    }
+
+    // do not sleep through the next sensor sample
+    uint32_t sample_ms = millis() - this->last_sample_ms;
+    uint32_t until_sample_ms = (SENSOR_SAMPLE_INTERVAL_MS > sample_ms) ? (SENSOR_SAMPLE_INTERVAL_MS - sample_ms) : 0;
+    duration_ms = min(duration_ms, until_sample_ms);
+
+    // do not hold pending updates longer than the aggregation window
+    if (0 < this->pending_updates.get_num_entries()) {
+        duration_ms = min(duration_ms, (uint32_t)AGGREGATE_WINDOW_MS);
+    }
+
+    // do not sleep through the next heartbeat
+    duration_ms = min(duration_ms, this->get_time_until_heartbeat());
+
+    this->sleep(min(duration_ms, timeout_ms), is_listening);
+#else
+    // do not wait past the slot pending updates must go out in
+    if (0 < this->pending_updates.get_num_entries() && true == this->is_synchronized()) {
+        timeout_ms = min(timeout_ms, this->get_time_until_slot());
+    }
+
+    (void) this->wait_for_message(timeout_ms);
+#endif
+}
+
+
+#if LOW_POWER_ENABLED
+void SensorNode::sleep(uint32_t duration_ms, bool is_radio_wake) {
+
+    // too short to sleep so wait instead
+    if (LOW_POWER_MIN_SLEEP_MS > duration_ms) {
+        (void) this->wait_for_message(duration_ms);
+        return;
+    }
+
+    // something already needs handling
+    if (true == is_radio_wake && true == this->is_message()) {
+        return;
+    }
+
+#if RF24_IRQ_ENABLED
+    // only a level interrupt can wake the microcontroller from power-down
+    if (true == is_radio_wake) {
+        attachInterrupt(digitalPinToInterrupt(RF24_IRQ_PIN), SensorNode::on_radio_irq, LOW);
+    }
+#endif
+
+    (void) low_power_sleep(duration_ms);
+
+#if RF24_IRQ_ENABLED
+    // an edge interrupt avoids retriggering while the radio is busy
+    if (true == is_radio_wake) {
+        attachInterrupt(digitalPinToInterrupt(RF24_IRQ_PIN), SensorNode::on_radio_irq, FALLING);
+    }
+#endif
 }
+#endif
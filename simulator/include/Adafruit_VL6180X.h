@@ -0,0 +1,38 @@
+/**
+* @brief: Contains the part of the VL6180X driver API the firmware uses, backed
+*         by the parking space of the running device.
+* @file: Adafruit_VL6180X.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _ADAFRUIT_VL6180X_H_
+#define _ADAFRUIT_VL6180X_H_
+
+// standard libraries
+#include <Arduino.h>
+
+#define VL6180X_ERROR_NONE 0        // range is valid
+#define VL6180X_ERROR_SYSERR_1 1    // system error
+#define VL6180X_ERROR_NOCONVERGE 11 // nothing within range
+
+
+class Adafruit_VL6180X {
+
+    public:
+
+        bool begin();
+
+        uint8_t readRange();
+
+        uint8_t readRangeStatus();
+
+        bool startRangeContinuous(uint16_t period_ms);
+
+        bool isRangeComplete();
+
+        uint8_t readRangeResult();
+};
+
+
+#endif // _ADAFRUIT_VL6180X_H_
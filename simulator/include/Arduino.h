@@ -0,0 +1,147 @@
+/**
+* @brief: Contains the parts of the Arduino core used by the firmware so it
+*         can be built for the host.
+* @file: Arduino.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _ARDUINO_H_
+#define _ARDUINO_H_
+
+// standard libraries
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/pgmspace.h>
+
+
+#define LOW 0
+#define HIGH 1
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define constrain(value, low, high) ((value) < (low) ? (low) : ((value) > (high) ? (high) : (value)))
+
+
+// current simulated time in microseconds, only advanced by the simulator
+extern uint64_t arduino_time_us;
+
+/**
+ * @brief Gets the time since the running device started
+ * 
+ * Stops while the device is in power-down sleep, like the timer behind it.
+ * 
+ * @return Time in milliseconds
+ */
+unsigned long millis();
+
+/**
+ * @brief Gets the time since the running device started
+ * 
+ * @return Time in microseconds
+ */
+unsigned long micros();
+
+/**
+ * @brief Lets simulated time pass on the running device
+ * 
+ * @param ms: time in milliseconds
+ */
+void delay(unsigned long ms);
+
+/**
+ * @brief Lets simulated time pass on the running device
+ * 
+ * @param us: time in microseconds
+ */
+void delayMicroseconds(unsigned int us);
+
+/**
+ * @brief Gets a pseudo random number from the running device's generator
+ * 
+ * @param max: upper bound (exclusive)
+ * @return Number from 0 to max - 1
+ */
+long random(long max);
+
+/**
+ * @brief Gets a pseudo random number from the running device's generator
+ * 
+ * @param min: lower bound (inclusive)
+ * @param max: upper bound (exclusive)
+ * @return Number from min to max - 1
+ */
+long random(long min, long max);
+
+/**
+ * @brief Seeds the running device's pseudo random number generator
+ * 
+ * @param seed: seed of the generator
+ */
+void randomSeed(unsigned long seed);
+
+// pins are not simulated
+inline void pinMode(uint8_t pin, uint8_t mode) { (void) pin; (void) mode; }
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+
+/**
+ * @brief Attaches a handler to an external interrupt of the running device
+ * 
+ * Only the radio's IRQ exists and the simulator polls the radio, so the
+ * handler is never called.
+ * 
+ * @param interrupt: external interrupt number
+ * @param handler: function to call
+ * @param mode: LOW, CHANGE, FALLING or RISING
+ */
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+// interrupts only run when a device resumes, never in between
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+template <typename T>
+inline T min(T a, T b) {
+
+    return (a < b) ? a : b;
+}
+
+template <typename T>
+inline T max(T a, T b) {
+
+    return (a > b) ? a : b;
+}
+
+
+// serial port of the running device
+class HardwareSerial {
+
+    public:
+
+        void begin(unsigned long baud);
+
+        int available();
+
+        int read();
+
+        int availableForWrite();
+
+        size_t write(const uint8_t* buffer, size_t size);
+
+        size_t println(const char* line);
+};
+
+extern HardwareSerial Serial;
+
+
+#endif // _ARDUINO_H_
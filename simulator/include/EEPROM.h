@@ -0,0 +1,54 @@
+/**
+* @brief: Contains the EEPROM library of the Arduino core, backed by the
+*         EEPROM of the running device.
+* @file: EEPROM.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _EEPROM_H_
+#define _EEPROM_H_
+
+// standard libraries
+#include <Arduino.h>
+#include <avr/io.h>
+
+
+/**
+ * @brief Gets the EEPROM of the running device
+ * 
+ * @return E2END + 1 bytes, which are blank outside of a device
+ */
+uint8_t* sim_eeprom();
+
+
+class EEPROMClass {
+
+    public:
+
+        template <typename T>
+        T& get(int address, T& value) {
+
+            memcpy(&value, sim_eeprom() + address, sizeof(T));
+
+            return value;
+        }
+
+        template <typename T>
+        const T& put(int address, const T& value) {
+
+            memcpy(sim_eeprom() + address, &value, sizeof(T));
+
+            return value;
+        }
+
+        uint16_t length() {
+
+            return E2END + 1;
+        }
+};
+
+extern EEPROMClass EEPROM;
+
+
+#endif // _EEPROM_H_
@@ -0,0 +1,93 @@
+/**
+* @brief: Contains the part of the RF24 driver API the firmware uses, backed
+*         by the simulated radio of the running device.
+* @file: RF24.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _RF24_H_
+#define _RF24_H_
+
+// standard libraries
+#include <Arduino.h>
+
+
+// power amplifier levels
+typedef enum {
+    RF24_PA_MIN = 0,
+    RF24_PA_LOW,
+    RF24_PA_HIGH,
+    RF24_PA_MAX,
+    RF24_PA_ERROR
+} rf24_pa_dbm_e;
+
+// air data rates
+typedef enum {
+    RF24_1MBPS = 0,
+    RF24_2MBPS,
+    RF24_250KBPS
+} rf24_datarate_e;
+
+
+class RF24 {
+
+    public:
+
+        RF24(uint16_t ce_pin, uint16_t csn_pin);
+
+        bool begin();
+
+        void setChannel(uint8_t channel);
+
+        void setAddressWidth(uint8_t width);
+
+        void setPALevel(uint8_t level);
+
+        bool setDataRate(rf24_datarate_e rate);
+
+        void setRetries(uint8_t delay, uint8_t count);
+
+        void setAutoAck(bool is_enabled);
+
+        void enableDynamicPayloads();
+
+        void enableDynamicAck();
+
+        void maskIRQ(bool tx_ok, bool tx_fail, bool rx_ready);
+
+        void whatHappened(bool& tx_ok, bool& tx_fail, bool& rx_ready);
+
+        void openReadingPipe(uint8_t pipe, uint64_t address);
+
+        void closeReadingPipe(uint8_t pipe);
+
+        void openWritingPipe(uint64_t address);
+
+        void startListening();
+
+        void stopListening();
+
+        void powerUp();
+
+        void powerDown();
+
+        bool testCarrier();
+
+        bool available();
+
+        bool available(uint8_t* pipe);
+
+        uint8_t getDynamicPayloadSize();
+
+        void read(void* buffer, uint8_t size);
+
+        bool write(const void* buffer, uint8_t size);
+
+        bool write(const void* buffer, uint8_t size, bool is_multicast);
+
+        uint8_t getARC();
+};
+
+
+#endif // _RF24_H_
@@ -0,0 +1,49 @@
+/**
+* @brief: Contains the part of the TVout API the base station uses, with a
+*         framebuffer that is never shown.
+* @file: TVout.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _TVOUT_H_
+#define _TVOUT_H_
+
+// standard libraries
+#include <Arduino.h>
+
+#define NTSC 0
+#define PAL 1
+
+#define BLACK 0
+#define WHITE 1
+#define INVERT 2
+
+
+class TVout {
+
+    public:
+
+        // 1 bit per pixel framebuffer
+        uint8_t* screen = NULL;
+
+        char begin(uint8_t mode, uint8_t x, uint8_t y);
+
+        void clear_screen();
+
+        /**
+         * @brief Sets the function called at the start of each vertical blank
+         * 
+         * Called about every 16.7 ms of simulated time when the device resumes.
+         * 
+         * @param func: function to call
+         */
+        void set_vbi_hook(void (*func)());
+
+    private:
+
+        uint16_t size = 0;
+};
+
+
+#endif // _TVOUT_H_
@@ -0,0 +1,26 @@
+/**
+* @brief: Contains the I2C bus of the Arduino core, which the simulated ToF
+*         sensor does not need.
+* @file: Wire.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _WIRE_H_
+#define _WIRE_H_
+
+// standard libraries
+#include <Arduino.h>
+
+
+class TwoWire {
+
+    public:
+
+        void begin() {}
+};
+
+extern TwoWire Wire;
+
+
+#endif // _WIRE_H_
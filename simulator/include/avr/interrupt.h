@@ -0,0 +1,21 @@
+/**
+* @brief: Contains the interrupt handling of avr-libc the firmware uses.
+* @file: interrupt.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _INTERRUPT_H_
+#define _INTERRUPT_H_
+
+// handlers are plain functions called by the simulator
+#define ISR(vector) extern "C" void vector(void); extern "C" void vector(void)
+
+// watchdog timer interrupt, called when a watchdog sleep ends
+#define WDT_vect sim_wdt_vect
+
+// interrupts only run when a device resumes, never in between
+#define sei()
+#define cli()
+
+#endif // _INTERRUPT_H_
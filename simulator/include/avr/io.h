@@ -0,0 +1,34 @@
+/**
+* @brief: Contains the registers of the ATmega328 the firmware touches.
+* @file: io.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _IO_H_
+#define _IO_H_
+
+// standard libraries
+#include <stdint.h>
+
+// last address of the 1 KB EEPROM
+#define E2END 0x3FF
+
+// registers only hold what the firmware writes to them
+extern volatile uint8_t ADCSRA;
+extern volatile uint8_t MCUSR;
+extern volatile uint8_t WDTCSR;
+
+#define ADEN 7  // ADC enable
+
+#define WDRF 3  // watchdog reset flag
+
+#define WDP0 0  // watchdog prescaler bits
+#define WDP1 1
+#define WDP2 2
+#define WDP3 5
+#define WDE 3   // watchdog reset enable
+#define WDCE 4  // watchdog change enable
+#define WDIE 6  // watchdog interrupt enable
+
+#endif // _IO_H_
@@ -0,0 +1,26 @@
+/**
+* @brief: Maps the flash access functions onto ordinary memory for the host.
+* @file: pgmspace.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _PGMSPACE_H_
+#define _PGMSPACE_H_
+
+// standard libraries
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+
+#define memcpy_P memcpy
+#define vsnprintf_P vsnprintf
+
+#endif // _PGMSPACE_H_
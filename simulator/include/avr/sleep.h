@@ -0,0 +1,33 @@
+/**
+* @brief: Contains the sleep modes of avr-libc the firmware uses.
+* @file: sleep.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _SLEEP_H_
+#define _SLEEP_H_
+
+// standard libraries
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE 0       // woken by any interrupt, including the 1 ms timer
+#define SLEEP_MODE_PWR_DOWN 2   // woken by the watchdog timer or an external interrupt
+
+/**
+ * @brief Selects the sleep mode of the running device
+ * 
+ * @param mode: SLEEP_MODE_IDLE or SLEEP_MODE_PWR_DOWN
+ */
+void set_sleep_mode(uint8_t mode);
+
+/**
+ * @brief Sleeps the running device until the next interrupt of the sleep mode
+ */
+void sleep_cpu();
+
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+inline void sleep_bod_disable() {}
+
+#endif // _SLEEP_H_
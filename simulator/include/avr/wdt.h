@@ -0,0 +1,29 @@
+/**
+* @brief: Contains the watchdog timer functions of avr-libc the firmware uses.
+* @file: wdt.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _WDT_H_
+#define _WDT_H_
+
+// standard libraries
+#include <avr/io.h>
+
+#define WDTO_15MS 0
+#define WDTO_30MS 1
+#define WDTO_60MS 2
+#define WDTO_120MS 3
+#define WDTO_250MS 4
+#define WDTO_500MS 5
+#define WDTO_1S 6
+#define WDTO_2S 7
+#define WDTO_4S 8
+#define WDTO_8S 9
+
+// the watchdog only runs while a device sleeps
+inline void wdt_reset() {}
+inline void wdt_disable() { WDTCSR = 0; }
+
+#endif // _WDT_H_
@@ -0,0 +1,272 @@
+/**
+* @brief: Contains the prototype of the Device class.
+* @file: device.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _DEVICE_HPP_
+#define _DEVICE_HPP_
+
+// standard libraries
+#include <Arduino.h>
+#include <avr/io.h>
+#include <deque>
+#include <ucontext.h>
+#include <vector>
+
+// local dependencies
+#include "simradio.hpp"
+
+
+#define SIM_STACK_SIZE (256 * 1024) // stack of each device's firmware in bytes
+#define SIM_EEPROM_SIZE (E2END + 1) // EEPROM of each device in bytes
+#define SIM_RANDOM_STATE_SIZE 128   // state of each device's random number generator in bytes
+
+#define SIM_VBI_INTERVAL_US 16683   // time between vertical blanks of an NTSC display
+#define SIM_SERIAL_BUFFER_SIZE 64   // serial transmit buffer of the Arduino core in bytes
+
+// millis() and micros() calls without time passing before time is forced to
+// pass, so firmware spinning on the clock still moves forward
+#define SIM_SPIN_CALLS_MAX 64
+#define SIM_SPIN_US 10
+
+#define SIM_RANGE_OCCUPIED_MM 40    // range the ToF sensor reads with a car in the space
+#define SIM_RANGE_VACANT_MM 255     // range the ToF sensor reads without anything in range
+#define SIM_RANGE_SINGLE_US 10000   // time a single shot range measurement takes
+
+
+class Simulator;
+
+
+// block of firmware globals each device has its own copy of
+struct sim_region_t {
+    void* address;
+    size_t size;
+};
+
+
+// firmware linked into the simulator
+struct sim_firmware_t {
+
+    // constructs the firmware's globals for a node, called on the node's stack
+    void (*construct)(uint8_t node_id);
+
+    // Arduino entry points of the firmware
+    void (*setup)();
+    void (*loop)();
+
+    // globals the firmware keeps its state in
+    const sim_region_t* regions;
+    uint8_t num_regions;
+};
+
+
+/**
+ * @brief A sensor node or base station running its firmware
+ * 
+ * Every device runs its firmware's setup() and loop() on a stack of its own
+ * and hands control back to the simulator whenever simulated time has to
+ * pass. Only one device runs at a time, so the firmware's globals are shared
+ * and each device's copy of them is swapped in before it runs.
+ */
+class Device {
+
+    private:
+
+        Simulator* sim = NULL;
+        const sim_firmware_t* firmware = NULL;
+        uint8_t node_id = 0;
+
+        // firmware, library and core globals and this device's copy of them
+        std::vector<sim_region_t> regions;
+        std::vector<uint8_t> image;
+
+        std::vector<uint8_t> stack;
+        ucontext_t context;
+
+        char random_state[SIM_RANDOM_STATE_SIZE];
+
+        // order of the event that resumes the device and if a received
+        // frame may resume it early
+        uint32_t wake_order = 0;
+        uint64_t wake_us = 0;
+        bool is_wake_on_frame = false;
+
+        // time spent in power-down sleep, when millis() stops
+        uint64_t power_down_us = 0;
+        uint32_t last_millis = 0;
+        uint8_t sleep_mode = 0;
+
+        uint64_t spin_us = 0;
+        uint8_t num_spin_calls = 0;
+
+        // display
+        void (*vbi_hook)() = NULL;
+        uint64_t vbi_us = 0;
+
+        // serial port
+        uint32_t serial_baud = 0;
+        uint64_t serial_drain_us = 0;
+        uint32_t serial_pending = 0;
+        std::deque<uint8_t> serial_input;
+
+        // parking space and ToF sensor
+        bool is_occupied = false;
+        uint16_t range_period_ms = 0;
+        uint64_t range_us = 0;
+
+        uint8_t eeprom[SIM_EEPROM_SIZE];
+
+        // device whose globals are currently in place
+        static Device* loaded;
+
+        // context of the simulator the devices return to
+        static ucontext_t sim_context;
+
+        /**
+         * @brief Runs the firmware of the device that is starting
+         */
+        static void run_firmware();
+
+        /**
+         * @brief Makes the device's copy of the globals current
+         */
+        void load();
+
+        /**
+         * @brief Copies the current globals into the device's copy
+         */
+        void save();
+
+        /**
+         * @brief Runs interrupts that became due while the device waited
+         */
+        void service_interrupts();
+
+        /**
+         * @brief Hands control to the simulator until the device is resumed
+         * 
+         * @param duration_us: time until the device resumes in microseconds
+         */
+        void suspend(uint64_t duration_us);
+
+
+    public:
+
+        // radio of the device
+        SimRadio radio;
+
+        /**
+         * @brief Constructs a Device object
+         * 
+         * Every device must be constructed before any of them runs, so each
+         * one starts from the globals as the firmware initialized them.
+         * 
+         * @param sim: simulator running the device
+         * @param firmware: firmware of the device
+         * @param node_id: ID of the node the device is
+         * @param seed: seed of the device's random number generator
+         */
+        Device(Simulator* sim, const sim_firmware_t* firmware, uint8_t node_id, uint32_t seed);
+
+        /**
+         * @brief Schedules the device to power up
+         */
+        void start();
+
+        /**
+         * @brief Runs the device's firmware until it next waits
+         * 
+         * Called by the simulator when the device's wake event is due.
+         */
+        void resume();
+
+        /**
+         * @brief Gets the order of the event the device waits for
+         * 
+         * @return Order of the wake event, older wake events are stale
+         */
+        uint32_t get_wake_order();
+
+        /**
+         * @brief Lets simulated time pass on the running device
+         * 
+         * @param duration_us: time in microseconds
+         * @param is_frame_wake: if a received frame ends the wait early
+         */
+        void wait(uint64_t duration_us, bool is_frame_wake = false);
+
+        /**
+         * @brief Ends a wait of the device early because a frame was received
+         */
+        void wake_on_frame();
+
+        /**
+         * @brief Gets the ID of the node the device is
+         * 
+         * @return ID of node
+         */
+        uint8_t get_id();
+
+        /**
+         * @brief Reads one of the device's globals
+         * 
+         * @param address: address of the global
+         * @param value: buffer for the value
+         * @param size: size of the global in bytes
+         */
+        void read_global(const void* address, void* value, size_t size);
+
+        // Arduino core of the running device
+        unsigned long get_millis();
+        unsigned long get_micros();
+        void set_sleep_mode(uint8_t mode);
+        void sleep_cpu();
+
+        uint8_t* get_eeprom();
+
+        // serial port of the running device, whose output goes to the simulator
+        void serial_begin(unsigned long baud);
+        int serial_available();
+        int serial_read();
+        int serial_available_for_write();
+        size_t serial_write(const uint8_t* buffer, size_t size);
+
+        /**
+         * @brief Sends bytes from a host to the device's serial port
+         * 
+         * @param buffer: bytes to send
+         * @param size: number of bytes
+         */
+        void serial_send(const uint8_t* buffer, size_t size);
+
+        // display of the running device
+        void set_vbi_hook(void (*hook)());
+
+        // ToF sensor of the running device
+        void set_occupied(bool is_occupied);
+        bool is_range_ready();
+        uint8_t read_range();
+        uint8_t read_range_status();
+        void start_ranging(uint16_t period_ms);
+};
+
+
+// device whose firmware is running, NULL while the simulator runs
+extern Device* sim_device;
+
+// Arduino core globals each device has its own copy of
+extern const sim_region_t sim_core_regions[];
+extern const uint8_t sim_num_core_regions;
+
+// library globals each device has its own copy of
+extern const sim_region_t sim_library_regions[];
+extern const uint8_t sim_num_library_regions;
+
+// firmware of the sensor nodes and the base station
+extern const sim_firmware_t sim_sensor_firmware;
+extern const sim_firmware_t sim_base_firmware;
+
+
+#endif // _DEVICE_HPP_
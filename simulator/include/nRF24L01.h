@@ -0,0 +1,12 @@
+/**
+* @brief: Contains the register map of the NRF24L01, which the simulated
+*         radio does not need.
+* @file: nRF24L01.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _NRF24L01_H_
+#define _NRF24L01_H_
+
+#endif // _NRF24L01_H_
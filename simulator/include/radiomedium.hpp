@@ -0,0 +1,104 @@
+/**
+* @brief: Contains the prototype of the RadioMedium class.
+* @file: radiomedium.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _RADIO_MEDIUM_HPP_
+#define _RADIO_MEDIUM_HPP_
+
+// standard libraries
+#include <Arduino.h>
+#include <map>
+#include <random>
+
+
+// Enhanced ShockBurst frame of the NRF24L01 as configured by the firmware
+#define RF24_PREAMBLE_BITS 8
+#define RF24_ADDRESS_BITS 32    // 4 byte addresses (RF24_ADDRESS_WIDTH)
+#define RF24_CONTROL_BITS 9     // packet control field of dynamic payloads
+#define RF24_CRC_BITS 16        // default 2 byte CRC
+
+#define RF24_SETTLE_US 130      // PLL settling before every transmission
+#define RF24_RETRY_STEP_US 250  // auto retransmit delay per step of setRetries()
+
+
+class RadioMedium {
+
+    private:
+
+        // frame on the air
+        struct transmission_t {
+            uint8_t channel;        // channel the frame is sent on
+            uint64_t end_us;        // time the frame is off the air
+            bool is_collided;       // another frame overlapped on the channel
+        };
+
+        std::map<uint32_t, transmission_t> transmissions;
+        uint32_t next_handle = 0;
+
+        double loss_rate = 0.0;
+
+        std::mt19937 rng;
+
+
+    public:
+
+        /**
+         * @brief Constructs a RadioMedium object
+         * 
+         * @param loss_rate: probability of any single frame being lost (0-1)
+         * @param seed: seed for the losses
+         */
+        RadioMedium(double loss_rate, uint32_t seed);
+
+        /**
+         * @brief Gets the time a frame occupies the channel
+         * 
+         * @param size: payload size in bytes (0 for an acknowledgement)
+         * @param data_rate_kbps: air data rate (250, 1000 or 2000)
+         * @return Time in microseconds, not including PLL settling
+         */
+        static uint32_t get_airtime_us(uint8_t size, uint32_t data_rate_kbps);
+
+        /**
+         * @brief Determines if a carrier is present as seen by testCarrier()
+         * 
+         * @param channel: channel to check
+         * @param now_us: current time in microseconds
+         * @return True if a frame is on the air on the channel. Otherwise false
+         */
+        bool is_carrier(uint8_t channel, uint64_t now_us);
+
+        /**
+         * @brief Puts a frame on the air
+         * 
+         * Frames overlapping on the same channel corrupt each other.
+         * 
+         * @param channel: channel the frame is sent on
+         * @param now_us: current time in microseconds
+         * @param airtime_us: time the frame occupies the channel
+         * @return Handle of the transmission
+         */
+        uint32_t begin(uint8_t channel, uint64_t now_us, uint32_t airtime_us);
+
+        /**
+         * @brief Takes a frame off the air
+         * 
+         * @param handle: handle returned by begin()
+         * @return True if the frame arrived intact. Otherwise false
+         */
+        bool end(uint32_t handle);
+
+        /**
+         * @brief Determines if a frame that does not contend for the channel,
+         *      such as an acknowledgement, is lost
+         * 
+         * @return True if the frame is lost. Otherwise false
+         */
+        bool is_lost();
+};
+
+
+#endif // _RADIO_MEDIUM_HPP_
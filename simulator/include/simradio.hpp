@@ -0,0 +1,160 @@
+/**
+* @brief: Contains the prototype of the SimRadio class.
+* @file: simradio.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _SIM_RADIO_HPP_
+#define _SIM_RADIO_HPP_
+
+// standard libraries
+#include <Arduino.h>
+#include <RF24.h>
+#include <deque>
+
+
+#define SIM_RADIO_NUM_PIPES 6       // reading pipes of the NRF24L01
+#define SIM_RADIO_FIFO_SIZE 3       // frames the NRF24L01 holds until they are read
+#define SIM_RADIO_PAYLOAD_SIZE 32   // largest payload of the NRF24L01
+#define SIM_RADIO_CHANNEL 76        // channel after begin() in the RF24 driver
+
+// time an empty available() call waits, unless a frame arrives first,
+// standing in for the firmware polling the radio
+#define SIM_RADIO_POLL_US 1000
+
+// time a write to a powered down radio fails after
+#define SIM_RADIO_TIMEOUT_US 1000
+
+
+class Device;
+class Simulator;
+
+
+// frame waiting in the receive FIFO
+struct sim_frame_t {
+    uint8_t pipe;
+    uint8_t size;
+    uint8_t payload[SIM_RADIO_PAYLOAD_SIZE];
+};
+
+
+/**
+ * @brief NRF24L01 of a device, in the states of it the RF24 driver uses
+ */
+class SimRadio {
+
+    private:
+
+        Simulator* sim = NULL;
+        Device* device = NULL;
+
+        bool is_powered = false;
+        bool is_listening = false;
+        uint64_t listen_us = 0;     // time the radio last started receiving on its channel
+
+        uint8_t channel = SIM_RADIO_CHANNEL;
+        uint8_t data_rate = RF24_1MBPS;
+        uint8_t pa_level = RF24_PA_MAX;
+        uint8_t retry_delay = 5;
+        uint8_t retry_count = 15;
+        uint8_t num_retries = 0;
+
+        uint64_t pipe_addresses[SIM_RADIO_NUM_PIPES] = {0};
+        uint8_t open_pipes = 0;
+        uint64_t tx_address = 0;
+
+        std::deque<sim_frame_t> rx_fifo;
+
+        // packet ID and CRC of the last frame of each pipe, which tell
+        // retransmissions of it apart
+        uint8_t tx_pid = 0;
+        uint8_t rx_pids[SIM_RADIO_NUM_PIPES] = {0};
+        uint16_t rx_crcs[SIM_RADIO_NUM_PIPES] = {0};
+
+        // time spent transmitting frames and acknowledgements
+        uint64_t airtime_us = 0;
+        uint32_t num_frames = 0;
+
+        /**
+         * @brief Starts receiving on the current channel
+         */
+        void restart_listening();
+
+
+    public:
+
+        /**
+         * @brief Attaches the radio to its device
+         * 
+         * @param sim: simulator the radio transmits through
+         * @param device: device the radio belongs to
+         */
+        void attach(Simulator* sim, Device* device);
+
+        // RF24 driver API
+        void set_channel(uint8_t channel);
+        void set_pa_level(uint8_t level);
+        void set_data_rate(uint8_t rate);
+        void set_retries(uint8_t delay, uint8_t count);
+        void open_reading_pipe(uint8_t pipe, uint64_t address);
+        void close_reading_pipe(uint8_t pipe);
+        void open_writing_pipe(uint64_t address);
+        void start_listening();
+        void stop_listening();
+        void power_up();
+        void power_down();
+        bool test_carrier();
+        bool available(uint8_t* pipe);
+        uint8_t get_payload_size();
+        void read(void* buffer, uint8_t size);
+        bool write(const void* buffer, uint8_t size, bool is_multicast);
+        uint8_t get_retries();
+
+        /**
+         * @brief Offers a frame that was on the air intact to the radio
+         * 
+         * @param address: address the frame was sent to
+         * @param channel: channel the frame was sent on
+         * @param data_rate: data rate the frame was sent at
+         * @param start_us: time the frame started
+         * @param buffer: payload
+         * @param size: size of payload in bytes
+         * @param pid: packet ID of the frame
+         * @param is_ack_expected: if the sender waits for an acknowledgement
+         * @return True if the frame is for the radio and it acknowledges it. Otherwise false
+         */
+        bool receive(uint64_t address, uint8_t channel, uint8_t data_rate, uint64_t start_us,
+                     const uint8_t* buffer, uint8_t size, uint8_t pid, bool is_ack_expected);
+
+        /**
+         * @brief Adds time the radio spent transmitting an acknowledgement
+         * 
+         * @param duration_us: time in microseconds
+         */
+        void add_airtime(uint32_t duration_us);
+
+        /**
+         * @brief Gets the time the radio spent transmitting
+         * 
+         * @return Time in microseconds
+         */
+        uint64_t get_airtime_us();
+
+        /**
+         * @brief Gets the number of frames the radio transmitted
+         * 
+         * @return Number of frames including retransmissions
+         */
+        uint32_t get_num_frames();
+
+        /**
+         * @brief Gets the air data rate of the radio
+         * 
+         * @return Data rate in kbps
+         */
+        uint32_t get_data_rate_kbps();
+};
+
+
+#endif // _SIM_RADIO_HPP_
@@ -0,0 +1,236 @@
+/**
+* @brief: Contains the prototype of the Simulator class.
+* @file: simulator.hpp
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _SIMULATOR_HPP_
+#define _SIMULATOR_HPP_
+
+// standard libraries
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+// local libraries
+#include <Layout.h>
+
+// local dependencies
+#include "device.hpp"
+#include "radiomedium.hpp"
+#include "simradio.hpp"
+
+
+#define SIM_EVENT_ARRIVAL 0 // parking space status changes
+#define SIM_EVENT_WAKE 1    // device resumes its firmware
+#define SIM_EVENT_CONFIG 2  // host sends a config to the base station
+
+#define SIM_PATTERN_POISSON 0   // each space changes at random with a mean interval
+#define SIM_PATTERN_PERIODIC 1  // each space changes every interval with a random phase
+#define SIM_PATTERN_BURST 2     // every space changes within a burst once per interval
+
+// time after power-up for the nodes to report their first status before
+// parking spaces start changing
+#define SIM_SETTLE_MS 10000
+
+// time after power-up the host sends its config
+#define SIM_CONFIG_MS 1000
+
+// time after the last status change for frames in flight to arrive
+#define SIM_DRAIN_MS 5000
+
+
+struct sim_config_t {
+    uint32_t duration_ms = 600000;      // time status changes are generated
+    double loss_rate = 0.0;             // probability of any single frame being lost
+    uint8_t pattern = SIM_PATTERN_POISSON;
+    uint32_t interval_ms = 30000;       // mean or fixed time between changes of a space
+    uint32_t burst_ms = 2000;           // length of each burst
+    uint32_t data_rate_kbps = 0;        // air data rate the host configures, 0 keeps the firmware's
+    uint32_t heartbeat_s = 0;           // heartbeat interval the host configures, 0 keeps the firmware's
+    uint32_t seed = 1;                  // seed of every random choice
+};
+
+
+class Simulator {
+
+    private:
+
+        // event due at a point in simulated time
+        struct event_t {
+            uint64_t time_us;
+            uint32_t order;     // keeps events at the same time in scheduling order
+            uint8_t type;
+            uint8_t node_id;
+
+            bool operator>(const event_t& other) const {
+                return (time_us != other.time_us) ? (time_us > other.time_us) : (order > other.order);
+            }
+        };
+
+        // parking space status change
+        struct change_t {
+            uint8_t node_id;
+            bool is_vacant;         // status after the change
+            uint64_t changed_us;
+            bool is_delivered;
+            bool is_superseded;     // replaced by a newer change before reaching the host
+        };
+
+        sim_config_t config;
+
+        std::priority_queue<event_t, std::vector<event_t>, std::greater<event_t>> events;
+        uint32_t num_events = 0;
+        uint64_t end_us = 0;
+
+        std::mt19937 rng;
+        RadioMedium medium;
+
+        // sensor nodes and sinks by ID, empty for unused IDs
+        std::unique_ptr<Device> devices[LAYOUT_MAX_NODE_ID + 1];
+
+        std::vector<change_t> changes;
+        int32_t latest_changes[LAYOUT_MAX_NODE_ID + 1];
+
+        // hops each status took to every device it reached, by device, origin and sequence
+        std::map<uint32_t, uint8_t> status_hops;
+        uint8_t sink_hops[LAYOUT_MAX_NODE_ID + 1];
+
+        // host on the base station's serial port
+        std::vector<uint8_t> host_frame;
+        int8_t host_statuses[LAYOUT_MAX_NODE_ID + 1];
+        uint32_t num_host_updates = 0;
+
+        std::vector<uint32_t> latencies_us;
+        std::vector<uint8_t> hop_counts;
+
+        /**
+         * @brief Schedules the next status change of a parking space
+         * 
+         * @param node_id: ID of node of the parking space
+         */
+        void schedule_arrival(uint8_t node_id);
+
+        /**
+         * @brief Changes the status of a parking space
+         * 
+         * @param node_id: ID of node of the parking space
+         */
+        void change_status(uint8_t node_id);
+
+        /**
+         * @brief Sends the host's config to the base station
+         */
+        void send_config();
+
+        /**
+         * @brief Handles a frame the host received from the base station
+         * 
+         * @param frame: COBS encoded frame without delimiters
+         * @param size: size of frame in bytes
+         */
+        void handle_host_frame(uint8_t* frame, uint8_t size);
+
+        /**
+         * @brief Records the status of a node as seen by the host
+         * 
+         * @param node_id: ID of node
+         * @param is_vacant: status of node
+         */
+        void update_host_status(uint8_t node_id, bool is_vacant);
+
+
+    public:
+
+        /**
+         * @brief Constructs a Simulator object for the lot in lib/Layout
+         * 
+         * @param config: simulation parameters
+         */
+        Simulator(sim_config_t config);
+
+        /**
+         * @brief Runs the simulation to completion
+         */
+        void run();
+
+        /**
+         * @brief Writes the results of the simulation
+         * 
+         * @param out: stream to write to
+         */
+        void report(FILE* out);
+
+        /**
+         * @brief Schedules an event
+         * 
+         * @param type: type of event
+         * @param node_id: ID of node handling the event
+         * @param delay_us: time from now in microseconds
+         * @return Order of the event
+         */
+        uint32_t schedule(uint8_t type, uint8_t node_id, uint64_t delay_us);
+
+        /**
+         * @brief Gets the time of the next event
+         * 
+         * @return Time in microseconds. Otherwise UINT64_MAX if nothing is scheduled
+         */
+        uint64_t get_next_event_us();
+
+        /**
+         * @brief Gets the time the simulation ends
+         * 
+         * @return Time in microseconds
+         */
+        uint64_t get_end_us();
+
+        /**
+         * @brief Gets the radio medium shared by every device
+         * 
+         * @return Radio medium
+         */
+        RadioMedium* get_medium();
+
+        /**
+         * @brief Offers a frame that arrived intact to every radio
+         * 
+         * @param address: address the frame was sent to
+         * @param channel: channel the frame was sent on
+         * @param data_rate: data rate the frame was sent at
+         * @param start_us: time the frame started
+         * @param buffer: payload
+         * @param size: size of payload in bytes
+         * @param pid: packet ID of the frame
+         * @param is_ack_expected: if the sender waits for an acknowledgement
+         * @return Radio that acknowledges the frame. Otherwise NULL
+         */
+        SimRadio* transmit(uint64_t address, uint8_t channel, uint8_t data_rate, uint64_t start_us,
+                           const uint8_t* buffer, uint8_t size, uint8_t pid, bool is_ack_expected);
+
+        /**
+         * @brief Records the statuses in a frame a device received
+         * 
+         * @param tx_id: ID of node that sent the frame
+         * @param rx_id: ID of node that received the frame
+         * @param buffer: payload
+         * @param size: size of payload in bytes
+         */
+        void record_frame(uint8_t tx_id, uint8_t rx_id, const uint8_t* buffer, uint8_t size);
+
+        /**
+         * @brief Handles bytes a device wrote to its serial port
+         * 
+         * @param node_id: ID of node that wrote them
+         * @param buffer: bytes written
+         * @param size: number of bytes
+         */
+        void receive_serial(uint8_t node_id, const uint8_t* buffer, size_t size);
+};
+
+
+#endif // _SIMULATOR_HPP_
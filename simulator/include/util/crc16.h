@@ -0,0 +1,32 @@
+/**
+* @brief: Contains the CRC functions of avr-libc used by the shared libraries.
+* @file: crc16.h
+*
+* @author: jkieltyka15
+*/
+
+#ifndef _CRC16_H_
+#define _CRC16_H_
+
+// standard libraries
+#include <stdint.h>
+
+/**
+ * @brief Updates a CRC-8 with the polynomial x^8 + x^2 + x + 1
+ * 
+ * @param crc: CRC of the previous bytes
+ * @param data: next byte
+ * @return Updated CRC
+ */
+static inline uint8_t _crc8_ccitt_update(uint8_t crc, uint8_t data) {
+
+    crc ^= data;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+
+    return crc;
+}
+
+#endif // _CRC16_H_
@@ -0,0 +1,171 @@
+/**
+* @brief: Contains the implementation of the host Arduino core.
+* @file: arduino.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+
+// local dependencies
+#include "device.hpp"
+
+
+uint64_t arduino_time_us = 0;
+
+// millisecond counter behind millis(), which the firmware may advance itself
+volatile unsigned long timer0_millis = 0;
+
+volatile uint8_t ADCSRA = 0;
+volatile uint8_t MCUSR = 0;
+volatile uint8_t WDTCSR = 0;
+
+const sim_region_t sim_core_regions[] = {
+    {(void*)&timer0_millis, sizeof(timer0_millis)},
+    {(void*)&ADCSRA, sizeof(ADCSRA)},
+    {(void*)&MCUSR, sizeof(MCUSR)},
+    {(void*)&WDTCSR, sizeof(WDTCSR)}
+};
+
+const uint8_t sim_num_core_regions = sizeof(sim_core_regions) / sizeof(sim_core_regions[0]);
+
+HardwareSerial Serial;
+
+
+unsigned long millis() {
+
+    // globals of the firmware are initialized before any device runs
+    if (NULL == sim_device) {
+        return (unsigned long)(arduino_time_us / 1000);
+    }
+
+    return sim_device->get_millis();
+}
+
+
+unsigned long micros() {
+
+    if (NULL == sim_device) {
+        return (unsigned long)arduino_time_us;
+    }
+
+    return sim_device->get_micros();
+}
+
+
+void delay(unsigned long ms) {
+
+    if (NULL != sim_device) {
+        sim_device->wait((uint64_t)ms * 1000);
+    }
+}
+
+
+void delayMicroseconds(unsigned int us) {
+
+    if (NULL != sim_device) {
+        sim_device->wait(us);
+    }
+}
+
+
+long random(long max) {
+
+    // matches the Arduino core, which also ignores empty ranges
+    if (0 >= max) {
+        return 0;
+    }
+
+    return random() % max;
+}
+
+
+long random(long min, long max) {
+
+    if (min >= max) {
+        return min;
+    }
+
+    return min + random(max - min);
+}
+
+
+void randomSeed(unsigned long seed) {
+
+    // each device's generator state is made current before it runs
+    srandom(seed);
+}
+
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode) {
+
+    (void) interrupt;
+    (void) handler;
+    (void) mode;
+}
+
+
+void detachInterrupt(uint8_t interrupt) {
+
+    (void) interrupt;
+}
+
+
+void set_sleep_mode(uint8_t mode) {
+
+    if (NULL != sim_device) {
+        sim_device->set_sleep_mode(mode);
+    }
+}
+
+
+void sleep_cpu() {
+
+    if (NULL != sim_device) {
+        sim_device->sleep_cpu();
+    }
+}
+
+
+void HardwareSerial::begin(unsigned long baud) {
+
+    if (NULL != sim_device) {
+        sim_device->serial_begin(baud);
+    }
+}
+
+
+int HardwareSerial::available() {
+
+    return (NULL != sim_device) ? sim_device->serial_available() : 0;
+}
+
+
+int HardwareSerial::read() {
+
+    return (NULL != sim_device) ? sim_device->serial_read() : -1;
+}
+
+
+int HardwareSerial::availableForWrite() {
+
+    return (NULL != sim_device) ? sim_device->serial_available_for_write() : 0;
+}
+
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+
+    return (NULL != sim_device) ? sim_device->serial_write(buffer, size) : 0;
+}
+
+
+size_t HardwareSerial::println(const char* line) {
+
+    // logged text of every device goes to stderr
+    return fprintf(stderr, "%lu.%03lu node %u: %s\n", (unsigned long)(arduino_time_us / 1000000),
+                   (unsigned long)((arduino_time_us / 1000) % 1000),
+                   (unsigned)((NULL != sim_device) ? sim_device->get_id() : 0), line);
+}
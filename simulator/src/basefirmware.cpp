@@ -0,0 +1,67 @@
+/**
+* @brief: Builds the base station firmware unchanged for the simulated sinks.
+* @file: basefirmware.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <new>
+
+// local libraries
+#include <Counters.h>
+#include <Log.h>
+#include <Message.h>
+
+// firmware headers come first so only the firmware's entry points are renamed
+#include "basestation.hpp"
+#include "parkingdisplay.hpp"
+#include "uplink.hpp"
+
+// both firmwares are linked into the simulator, so each names its entry points
+#define setup base_setup
+#define loop base_loop
+#include "../../base_station/arduino/src/main.cpp"
+#undef setup
+#undef loop
+
+#include "../../base_station/arduino/src/basestation.cpp"
+#include "../../base_station/arduino/src/parkingdisplay.cpp"
+#include "../../base_station/arduino/src/uplink.cpp"
+
+// local dependencies
+#include "device.hpp"
+
+
+/**
+ * @brief Constructs the base station of the running device
+ * 
+ * @param node_id: ID of the sink
+ */
+static void construct(uint8_t node_id) {
+
+    new (&base_station) BaseStation(node_id);
+    new (&uplink) Uplink(&base_station);
+}
+
+
+// globals of the base station firmware
+static const sim_region_t regions[] = {
+    {(void*)&base_station, sizeof(base_station)},
+    {(void*)&uplink, sizeof(uplink)},
+    {(void*)&screen, sizeof(screen)},
+    {(void*)dirty_spaces, sizeof(dirty_spaces)},
+    {(void*)space_vacancies, sizeof(space_vacancies)},
+    {(void*)unconfirmed_spaces, sizeof(unconfirmed_spaces)},
+    {(void*)&num_dirty_spaces, sizeof(num_dirty_spaces)},
+    {(void*)&is_frame_started, sizeof(is_frame_started)}
+};
+
+const sim_firmware_t sim_base_firmware = {
+    construct,
+    base_setup,
+    base_loop,
+    regions,
+    sizeof(regions) / sizeof(regions[0])
+};
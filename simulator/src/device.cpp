@@ -0,0 +1,429 @@
+/**
+* @brief: Contains the implementation of the Device class.
+* @file: device.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <Adafruit_VL6180X.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+
+// local dependencies
+#include "device.hpp"
+#include "simulator.hpp"
+
+
+// milliseconds of each watchdog timer period (WDTO_15MS to WDTO_8S)
+static const uint16_t wdt_period_ms[] = {16, 32, 64, 125, 250, 500, 1000, 2000, 4000, 8000};
+
+// millisecond counter behind millis() from the Arduino core
+extern volatile unsigned long timer0_millis;
+
+// watchdog timer interrupt handler of the firmware, if it has one
+extern "C" void sim_wdt_vect(void) __attribute__((weak));
+
+Device* sim_device = NULL;
+
+Device* Device::loaded = NULL;
+ucontext_t Device::sim_context;
+
+
+Device::Device(Simulator* sim, const sim_firmware_t* firmware, uint8_t node_id, uint32_t seed) {
+
+    this->sim = sim;
+    this->firmware = firmware;
+    this->node_id = node_id;
+
+    // globals of the firmware and of the libraries and core it is built with
+    this->regions.assign(firmware->regions, firmware->regions + firmware->num_regions);
+    this->regions.insert(this->regions.end(), sim_library_regions, sim_library_regions + sim_num_library_regions);
+    this->regions.insert(this->regions.end(), sim_core_regions, sim_core_regions + sim_num_core_regions);
+
+    // start from the globals as the firmware initialized them
+    for (const sim_region_t& region : this->regions) {
+        const uint8_t* data = (const uint8_t*)region.address;
+        this->image.insert(this->image.end(), data, data + region.size);
+    }
+
+    // blank EEPROM
+    memset(this->eeprom, 0xFF, sizeof(this->eeprom));
+
+    (void) initstate(seed, this->random_state, sizeof(this->random_state));
+
+    this->radio.attach(sim, this);
+
+    // firmware starts on a stack of its own the first time the device resumes
+    this->stack.resize(SIM_STACK_SIZE);
+
+    getcontext(&this->context);
+    this->context.uc_stack.ss_sp = this->stack.data();
+    this->context.uc_stack.ss_size = this->stack.size();
+    this->context.uc_link = &Device::sim_context;
+    makecontext(&this->context, Device::run_firmware, 0);
+}
+
+
+void Device::run_firmware() {
+
+    Device* device = sim_device;
+
+    device->firmware->construct(device->node_id);
+    device->firmware->setup();
+
+    while (true) {
+        device->firmware->loop();
+    }
+}
+
+
+void Device::load() {
+
+    size_t offset = 0;
+
+    for (const sim_region_t& region : this->regions) {
+        memcpy(region.address, &this->image[offset], region.size);
+        offset += region.size;
+    }
+
+    Device::loaded = this;
+}
+
+
+void Device::save() {
+
+    size_t offset = 0;
+
+    for (const sim_region_t& region : this->regions) {
+        memcpy(&this->image[offset], region.address, region.size);
+        offset += region.size;
+    }
+}
+
+
+void Device::start() {
+
+    this->wake_us = arduino_time_us;
+    this->wake_order = this->sim->schedule(SIM_EVENT_WAKE, this->node_id, 0);
+}
+
+
+void Device::resume() {
+
+    // globals stay in place while the same device keeps running
+    if (this != Device::loaded) {
+
+        if (NULL != Device::loaded) {
+            Device::loaded->save();
+        }
+
+        this->load();
+    }
+
+    sim_device = this;
+    (void) setstate(this->random_state);
+
+    swapcontext(&Device::sim_context, &this->context);
+
+    sim_device = NULL;
+}
+
+
+uint32_t Device::get_wake_order() {
+
+    return this->wake_order;
+}
+
+
+void Device::suspend(uint64_t duration_us) {
+
+    this->wake_us = arduino_time_us + duration_us;
+    this->wake_order = this->sim->schedule(SIM_EVENT_WAKE, this->node_id, duration_us);
+
+    swapcontext(&this->context, &Device::sim_context);
+}
+
+
+void Device::wait(uint64_t duration_us, bool is_frame_wake) {
+
+    if (0 == duration_us) {
+        return;
+    }
+
+    uint64_t until_us = arduino_time_us + duration_us;
+
+    // nothing else happens in the meantime, so time passes without switching devices
+    if (this->sim->get_next_event_us() > until_us && this->sim->get_end_us() >= until_us) {
+        arduino_time_us = until_us;
+    }
+
+    else {
+        this->is_wake_on_frame = is_frame_wake;
+        this->suspend(duration_us);
+        this->is_wake_on_frame = false;
+    }
+
+    this->service_interrupts();
+}
+
+
+void Device::wake_on_frame() {
+
+    if (false == this->is_wake_on_frame || this->wake_us <= arduino_time_us) {
+        return;
+    }
+
+    // resume right away, which makes the pending wake event stale
+    this->is_wake_on_frame = false;
+    this->wake_us = arduino_time_us;
+    this->wake_order = this->sim->schedule(SIM_EVENT_WAKE, this->node_id, 0);
+}
+
+
+void Device::service_interrupts() {
+
+    // start of vertical blanking of the display
+    if (NULL != this->vbi_hook && this->vbi_us <= arduino_time_us) {
+
+        uint64_t late_us = (arduino_time_us - this->vbi_us) % SIM_VBI_INTERVAL_US;
+        this->vbi_us = arduino_time_us - late_us + SIM_VBI_INTERVAL_US;
+
+        this->vbi_hook();
+    }
+}
+
+
+uint8_t Device::get_id() {
+
+    return this->node_id;
+}
+
+
+void Device::read_global(const void* address, void* value, size_t size) {
+
+    // current values of the running device are in place
+    if (this == Device::loaded) {
+        memcpy(value, address, size);
+        return;
+    }
+
+    size_t offset = 0;
+
+    for (const sim_region_t& region : this->regions) {
+
+        const uint8_t* start = (const uint8_t*)region.address;
+
+        if (start <= (const uint8_t*)address && start + region.size >= (const uint8_t*)address + size) {
+            memcpy(value, &this->image[offset + ((const uint8_t*)address - start)], size);
+            return;
+        }
+
+        offset += region.size;
+    }
+
+    memset(value, 0, size);
+}
+
+
+unsigned long Device::get_millis() {
+
+    (void) this->get_micros();
+
+    // the core counts milliseconds in timer0_millis, which the firmware
+    // advances itself after sleeping
+    uint32_t running_ms = (uint32_t)((arduino_time_us - this->power_down_us) / 1000);
+    timer0_millis += running_ms - this->last_millis;
+    this->last_millis = running_ms;
+
+    return timer0_millis;
+}
+
+
+unsigned long Device::get_micros() {
+
+    // firmware waiting on the clock alone still moves forward
+    if (this->spin_us != arduino_time_us) {
+        this->spin_us = arduino_time_us;
+        this->num_spin_calls = 0;
+    }
+
+    else if (SIM_SPIN_CALLS_MAX <= ++this->num_spin_calls) {
+        this->wait(SIM_SPIN_US);
+    }
+
+    return (unsigned long)(arduino_time_us - this->power_down_us);
+}
+
+
+void Device::set_sleep_mode(uint8_t mode) {
+
+    this->sleep_mode = mode;
+}
+
+
+void Device::sleep_cpu() {
+
+    // idle sleep ends with the next interrupt of the 1 ms timer at the latest
+    if (SLEEP_MODE_PWR_DOWN != this->sleep_mode) {
+        this->wait(1000, true);
+        return;
+    }
+
+    // nothing to wake up from
+    if (0 == (WDTCSR & (1 << WDIE))) {
+        this->wait(this->sim->get_end_us() + 1 - arduino_time_us);
+        return;
+    }
+
+    uint8_t prescaler = (WDTCSR & 0x07) | ((WDTCSR & (1 << WDP3)) ? 0x08 : 0);
+    uint64_t period_us = (uint64_t)wdt_period_ms[min(prescaler, (uint8_t)9)] * 1000;
+
+    // timer behind millis() stops while powered down
+    this->wait(period_us);
+    this->power_down_us += period_us;
+
+    if (NULL != sim_wdt_vect) {
+        sim_wdt_vect();
+    }
+}
+
+
+uint8_t* Device::get_eeprom() {
+
+    return this->eeprom;
+}
+
+
+void Device::serial_begin(unsigned long baud) {
+
+    this->serial_baud = baud;
+    this->serial_drain_us = arduino_time_us;
+    this->serial_pending = 0;
+}
+
+
+int Device::serial_available() {
+
+    return (int)this->serial_input.size();
+}
+
+
+int Device::serial_read() {
+
+    if (true == this->serial_input.empty()) {
+        return -1;
+    }
+
+    uint8_t data = this->serial_input.front();
+    this->serial_input.pop_front();
+
+    return data;
+}
+
+
+int Device::serial_available_for_write() {
+
+    // serial port was never started
+    if (0 == this->serial_baud) {
+        return 0;
+    }
+
+    // every byte takes 10 bits on the wire
+    uint64_t byte_us = 10000000 / this->serial_baud;
+    uint64_t num_sent = (arduino_time_us - this->serial_drain_us) / byte_us;
+
+    if (num_sent >= this->serial_pending) {
+        this->serial_pending = 0;
+        this->serial_drain_us = arduino_time_us;
+    }
+
+    else {
+        this->serial_pending -= (uint32_t)num_sent;
+        this->serial_drain_us += num_sent * byte_us;
+    }
+
+    return SIM_SERIAL_BUFFER_SIZE - 1 - (int)this->serial_pending;
+}
+
+
+size_t Device::serial_write(const uint8_t* buffer, size_t size) {
+
+    // serial port was never started
+    if (0 == this->serial_baud) {
+        return 0;
+    }
+
+    int num_free = this->serial_available_for_write();
+
+    // block until the bytes that do not fit have been sent, like the core does
+    if ((int)size > num_free) {
+        this->wait((uint64_t)(size - num_free) * (10000000 / this->serial_baud));
+        (void) this->serial_available_for_write();
+    }
+
+    this->serial_pending = min((uint32_t)(this->serial_pending + size), (uint32_t)(SIM_SERIAL_BUFFER_SIZE - 1));
+    this->sim->receive_serial(this->node_id, buffer, size);
+
+    return size;
+}
+
+
+void Device::serial_send(const uint8_t* buffer, size_t size) {
+
+    this->serial_input.insert(this->serial_input.end(), buffer, buffer + size);
+}
+
+
+void Device::set_vbi_hook(void (*hook)()) {
+
+    this->vbi_hook = hook;
+    this->vbi_us = arduino_time_us + SIM_VBI_INTERVAL_US;
+}
+
+
+void Device::set_occupied(bool is_occupied) {
+
+    this->is_occupied = is_occupied;
+}
+
+
+bool Device::is_range_ready() {
+
+    return 0 < this->range_period_ms && this->range_us <= arduino_time_us;
+}
+
+
+uint8_t Device::read_range() {
+
+    // single shot measurement
+    if (0 == this->range_period_ms) {
+        this->wait(SIM_RANGE_SINGLE_US);
+    }
+
+    // next continuous measurement
+    else {
+
+        uint64_t period_us = (uint64_t)this->range_period_ms * 1000;
+
+        while (this->range_us <= arduino_time_us) {
+            this->range_us += period_us;
+        }
+    }
+
+    return (true == this->is_occupied) ? SIM_RANGE_OCCUPIED_MM : SIM_RANGE_VACANT_MM;
+}
+
+
+uint8_t Device::read_range_status() {
+
+    return (true == this->is_occupied) ? VL6180X_ERROR_NONE : VL6180X_ERROR_NOCONVERGE;
+}
+
+
+void Device::start_ranging(uint16_t period_ms) {
+
+    this->range_period_ms = period_ms;
+    this->range_us = arduino_time_us + ((uint64_t)period_ms * 1000);
+}
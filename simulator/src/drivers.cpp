@@ -0,0 +1,262 @@
+/**
+* @brief: Contains the implementation of the host device drivers, which act on
+*         the running device.
+* @file: drivers.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <Adafruit_VL6180X.h>
+#include <EEPROM.h>
+#include <RF24.h>
+#include <TVout.h>
+#include <Wire.h>
+
+// local dependencies
+#include "device.hpp"
+
+
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+// EEPROM read while the firmware's globals are initialized, before any device runs
+static uint8_t blank_eeprom[E2END + 1];
+
+
+uint8_t* sim_eeprom() {
+
+    if (NULL == sim_device) {
+        memset(blank_eeprom, 0xFF, sizeof(blank_eeprom));
+        return blank_eeprom;
+    }
+
+    return sim_device->get_eeprom();
+}
+
+
+RF24::RF24(uint16_t ce_pin, uint16_t csn_pin) {
+
+    (void) ce_pin;
+    (void) csn_pin;
+}
+
+
+bool RF24::begin() {
+
+    sim_device->radio.power_up();
+
+    return true;
+}
+
+
+void RF24::setChannel(uint8_t channel) {
+
+    sim_device->radio.set_channel(channel);
+}
+
+
+void RF24::setAddressWidth(uint8_t width) {
+
+    (void) width;
+}
+
+
+void RF24::setPALevel(uint8_t level) {
+
+    sim_device->radio.set_pa_level(level);
+}
+
+
+bool RF24::setDataRate(rf24_datarate_e rate) {
+
+    sim_device->radio.set_data_rate(rate);
+
+    return true;
+}
+
+
+void RF24::setRetries(uint8_t delay, uint8_t count) {
+
+    sim_device->radio.set_retries(delay, count);
+}
+
+
+void RF24::setAutoAck(bool is_enabled) {
+
+    (void) is_enabled;
+}
+
+
+void RF24::enableDynamicPayloads() {}
+
+
+void RF24::enableDynamicAck() {}
+
+
+void RF24::maskIRQ(bool tx_ok, bool tx_fail, bool rx_ready) {
+
+    (void) tx_ok;
+    (void) tx_fail;
+    (void) rx_ready;
+}
+
+
+void RF24::whatHappened(bool& tx_ok, bool& tx_fail, bool& rx_ready) {
+
+    tx_ok = false;
+    tx_fail = false;
+    rx_ready = false;
+}
+
+
+void RF24::openReadingPipe(uint8_t pipe, uint64_t address) {
+
+    sim_device->radio.open_reading_pipe(pipe, address);
+}
+
+
+void RF24::closeReadingPipe(uint8_t pipe) {
+
+    sim_device->radio.close_reading_pipe(pipe);
+}
+
+
+void RF24::openWritingPipe(uint64_t address) {
+
+    sim_device->radio.open_writing_pipe(address);
+}
+
+
+void RF24::startListening() {
+
+    sim_device->radio.start_listening();
+}
+
+
+void RF24::stopListening() {
+
+    sim_device->radio.stop_listening();
+}
+
+
+void RF24::powerUp() {
+
+    sim_device->radio.power_up();
+}
+
+
+void RF24::powerDown() {
+
+    sim_device->radio.power_down();
+}
+
+
+bool RF24::testCarrier() {
+
+    return sim_device->radio.test_carrier();
+}
+
+
+bool RF24::available() {
+
+    return sim_device->radio.available(NULL);
+}
+
+
+bool RF24::available(uint8_t* pipe) {
+
+    return sim_device->radio.available(pipe);
+}
+
+
+uint8_t RF24::getDynamicPayloadSize() {
+
+    return sim_device->radio.get_payload_size();
+}
+
+
+void RF24::read(void* buffer, uint8_t size) {
+
+    sim_device->radio.read(buffer, size);
+}
+
+
+bool RF24::write(const void* buffer, uint8_t size) {
+
+    return sim_device->radio.write(buffer, size, false);
+}
+
+
+bool RF24::write(const void* buffer, uint8_t size, bool is_multicast) {
+
+    return sim_device->radio.write(buffer, size, is_multicast);
+}
+
+
+uint8_t RF24::getARC() {
+
+    return sim_device->radio.get_retries();
+}
+
+
+bool Adafruit_VL6180X::begin() {
+
+    return true;
+}
+
+
+uint8_t Adafruit_VL6180X::readRange() {
+
+    return sim_device->read_range();
+}
+
+
+uint8_t Adafruit_VL6180X::readRangeStatus() {
+
+    return sim_device->read_range_status();
+}
+
+
+bool Adafruit_VL6180X::startRangeContinuous(uint16_t period_ms) {
+
+    sim_device->start_ranging(period_ms);
+
+    return true;
+}
+
+
+bool Adafruit_VL6180X::isRangeComplete() {
+
+    return sim_device->is_range_ready();
+}
+
+
+uint8_t Adafruit_VL6180X::readRangeResult() {
+
+    return sim_device->read_range();
+}
+
+
+char TVout::begin(uint8_t mode, uint8_t x, uint8_t y) {
+
+    (void) mode;
+
+    this->size = (x / 8) * y;
+    this->screen = (uint8_t*)calloc(this->size, 1);
+
+    return (NULL == this->screen) ? 4 : 0;
+}
+
+
+void TVout::clear_screen() {
+
+    memset(this->screen, 0, this->size);
+}
+
+
+void TVout::set_vbi_hook(void (*func)()) {
+
+    sim_device->set_vbi_hook(func);
+}
@@ -0,0 +1,36 @@
+/**
+* @brief: Builds the libraries that keep state in globals, so every simulated
+*         device gets its own copy of it.
+* @file: libraries.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+#include "../../lib/Counters/Counters.cpp"
+#include "../../lib/Log/Log.cpp"
+
+// local dependencies
+#include "device.hpp"
+
+
+// globals of the libraries
+const sim_region_t sim_library_regions[] = {
+#if COUNTERS_ENABLED
+    {(void*)counter_values, sizeof(counter_values)},
+    {(void*)&loop_start_us, sizeof(loop_start_us)},
+    {(void*)&is_loop_started, sizeof(is_loop_started)},
+#endif
+#if LOG_BINARY_ENABLED
+    {(void*)&num_dropped, sizeof(num_dropped)},
+    {(void*)ring, sizeof(ring)},
+    {(void*)&ring_head, sizeof(ring_head)},
+    {(void*)&ring_tail, sizeof(ring_tail)},
+    {(void*)&sequence, sizeof(sequence)},
+#endif
+    {NULL, 0}
+};
+
+const uint8_t sim_num_library_regions = sizeof(sim_library_regions) / sizeof(sim_library_regions[0]) - 1;
@@ -0,0 +1,139 @@
+/**
+* @brief: Contains the entry point of the sensor network simulator.
+* @file: main.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local libraries
+#include <Message.h>
+
+// local dependencies
+#include "simulator.hpp"
+
+
+/**
+ * @brief Writes the command line options
+ * 
+ * @param name: name the program was run as
+ */
+static void print_usage(const char* name) {
+
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --seconds N        time status changes are generated (default 600)\n"
+            "  --pattern NAME     poisson, periodic or burst (default poisson)\n"
+            "  --interval-ms N    mean or fixed time between changes of a space (default 30000)\n"
+            "  --burst-ms N       length of each burst of the burst pattern (default 2000)\n"
+            "  --loss P           probability of any single frame being lost (default 0)\n"
+            "  --rate KBPS        air data rate the host configures: 250, 1000 or 2000\n"
+            "  --heartbeat-s N    heartbeat interval the host configures (1-254)\n"
+            "  --seed N           seed of every random choice (default 1)\n"
+            "The lot is the one described in lib/Layout. Without --rate or --heartbeat-s the\n"
+            "nodes keep the settings they are built with.\n",
+            name);
+}
+
+
+/**
+ * @brief Parses the command line options
+ * 
+ * @param argc: number of arguments
+ * @param argv: arguments
+ * @param config: parsed parameters
+ * @return True on success. Otherwise false
+ */
+static bool parse_options(int argc, char** argv, sim_config_t* config) {
+
+    for (int i = 1; i < argc; i++) {
+
+        const char* option = argv[i];
+
+        // every option takes a value
+        if (argc <= i + 1) {
+            return false;
+        }
+
+        const char* value = argv[++i];
+
+        if (0 == strcmp(option, "--seconds")) {
+            config->duration_ms = strtoul(value, NULL, 10) * 1000;
+        }
+
+        else if (0 == strcmp(option, "--pattern")) {
+
+            if (0 == strcmp(value, "poisson")) {
+                config->pattern = SIM_PATTERN_POISSON;
+            }
+
+            else if (0 == strcmp(value, "periodic")) {
+                config->pattern = SIM_PATTERN_PERIODIC;
+            }
+
+            else if (0 == strcmp(value, "burst")) {
+                config->pattern = SIM_PATTERN_BURST;
+            }
+
+            else {
+                return false;
+            }
+        }
+
+        else if (0 == strcmp(option, "--interval-ms")) {
+            config->interval_ms = strtoul(value, NULL, 10);
+        }
+
+        else if (0 == strcmp(option, "--burst-ms")) {
+            config->burst_ms = strtoul(value, NULL, 10);
+        }
+
+        else if (0 == strcmp(option, "--loss")) {
+            config->loss_rate = strtod(value, NULL);
+        }
+
+        else if (0 == strcmp(option, "--rate")) {
+            config->data_rate_kbps = strtoul(value, NULL, 10);
+        }
+
+        else if (0 == strcmp(option, "--heartbeat-s")) {
+            config->heartbeat_s = strtoul(value, NULL, 10);
+        }
+
+        else if (0 == strcmp(option, "--seed")) {
+            config->seed = strtoul(value, NULL, 10);
+        }
+
+        else {
+            return false;
+        }
+    }
+
+    // same limits as the config message and the radio
+    return 0 < config->duration_ms
+        && 0 < config->interval_ms
+        && CONFIG_KEEP > config->heartbeat_s
+        && 0.0 <= config->loss_rate && 1.0 >= config->loss_rate
+        && (0 == config->data_rate_kbps || 250 == config->data_rate_kbps
+            || 1000 == config->data_rate_kbps || 2000 == config->data_rate_kbps);
+}
+
+
+int main(int argc, char** argv) {
+
+    sim_config_t config;
+
+    if (false == parse_options(argc, argv, &config)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Simulator sim = Simulator(config);
+
+    sim.run();
+    sim.report(stdout);
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+* @brief: Contains the implementation of the RadioMedium class.
+* @file: radiomedium.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "radiomedium.hpp"
+
+
+RadioMedium::RadioMedium(double loss_rate, uint32_t seed) : rng(seed) {
+
+    this->loss_rate = loss_rate;
+}
+
+
+uint32_t RadioMedium::get_airtime_us(uint8_t size, uint32_t data_rate_kbps) {
+
+    uint32_t bits = RF24_PREAMBLE_BITS + RF24_ADDRESS_BITS + RF24_CONTROL_BITS
+                  + (8 * (uint32_t)size) + RF24_CRC_BITS;
+
+    // round up to whole microseconds
+    return ((bits * 1000) + data_rate_kbps - 1) / data_rate_kbps;
+}
+
+
+bool RadioMedium::is_carrier(uint8_t channel, uint64_t now_us) {
+
+    for (auto& entry : this->transmissions) {
+
+        if (channel == entry.second.channel && now_us < entry.second.end_us) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+uint32_t RadioMedium::begin(uint8_t channel, uint64_t now_us, uint32_t airtime_us) {
+
+    transmission_t transmission = {channel, now_us + airtime_us, false};
+
+    // every frame still on the air on the channel overlaps the new one
+    for (auto& entry : this->transmissions) {
+
+        if (channel == entry.second.channel && now_us < entry.second.end_us) {
+            entry.second.is_collided = true;
+            transmission.is_collided = true;
+        }
+    }
+
+    uint32_t handle = this->next_handle++;
+    this->transmissions[handle] = transmission;
+
+    return handle;
+}
+
+
+bool RadioMedium::end(uint32_t handle) {
+
+    auto entry = this->transmissions.find(handle);
+
+    // unknown transmission
+    if (this->transmissions.end() == entry) {
+        return false;
+    }
+
+    bool is_collided = entry->second.is_collided;
+    this->transmissions.erase(entry);
+
+    return false == is_collided && false == this->is_lost();
+}
+
+
+bool RadioMedium::is_lost() {
+
+    return std::uniform_real_distribution<double>(0.0, 1.0)(this->rng) < this->loss_rate;
+}
@@ -0,0 +1,71 @@
+/**
+* @brief: Builds the sensor node firmware unchanged for the simulated nodes.
+* @file: sensorfirmware.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <new>
+
+// local libraries
+#include <Counters.h>
+#include <Log.h>
+#include <Message.h>
+
+// firmware headers come first so only the firmware's entry points are renamed
+#include "lowpower.hpp"
+#include "parkingmap.hpp"
+#include "sensornode.hpp"
+
+// both firmwares are linked into the simulator, so each names its entry points
+#define setup sensor_setup
+#define loop sensor_loop
+#include "../../sensor_node/arduino/src/main.cpp"
+#undef setup
+#undef loop
+
+#include "../../sensor_node/arduino/src/lowpower.cpp"
+#include "../../sensor_node/arduino/src/parkingmap.cpp"
+#include "../../sensor_node/arduino/src/sensornode.cpp"
+
+// local dependencies
+#include "device.hpp"
+
+
+/**
+ * @brief Constructs the sensor node of the running device
+ * 
+ * @param node_id: ID of node
+ */
+static void construct(uint8_t node_id) {
+
+    config_settings_t settings;
+    memset(&settings, CONFIG_KEEP, sizeof(settings));
+    settings.node_id = node_id;
+
+    // nodes get their IDs over the air, so start from a config that gave it
+    config_record_t record;
+    record.config = ConfigMessage(node_id, BASE_STATION_ID, node_id, CONFIG_VERSION_NONE, settings);
+    record.crc = frame_crc((uint8_t*)&record, sizeof(record) - 1);
+    EEPROM.put(EEPROM_CONFIG_ADDRESS, record);
+
+    new (&node) SensorNode(SensorNode::get_configured_id(NODE_ID));
+}
+
+
+// globals of the sensor node firmware
+static const sim_region_t regions[] = {
+    {(void*)&node, sizeof(node)},
+    {(void*)&is_wdt_wake, sizeof(is_wdt_wake)}
+};
+
+const sim_firmware_t sim_sensor_firmware = {
+    construct,
+    sensor_setup,
+    sensor_loop,
+    regions,
+    sizeof(regions) / sizeof(regions[0])
+};
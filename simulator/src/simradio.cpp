@@ -0,0 +1,346 @@
+/**
+* @brief: Contains the implementation of the SimRadio class.
+* @file: simradio.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+
+// local dependencies
+#include "device.hpp"
+#include "radiomedium.hpp"
+#include "simradio.hpp"
+#include "simulator.hpp"
+
+
+/**
+ * @brief Calculates the CRC the radio compares to tell retransmissions apart
+ * 
+ * @param buffer: payload
+ * @param size: size of payload in bytes
+ * @return CRC-16 of the payload
+ */
+static uint16_t payload_crc(const uint8_t* buffer, uint8_t size) {
+
+    uint16_t crc = 0xFFFF;
+
+    for (uint8_t i = 0; i < size; i++) {
+
+        crc ^= (uint16_t)buffer[i] << 8;
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+
+void SimRadio::attach(Simulator* sim, Device* device) {
+
+    this->sim = sim;
+    this->device = device;
+}
+
+
+void SimRadio::restart_listening() {
+
+    this->listen_us = arduino_time_us;
+}
+
+
+void SimRadio::set_channel(uint8_t channel) {
+
+    this->channel = min(channel, (uint8_t)125);
+    this->restart_listening();
+}
+
+
+void SimRadio::set_pa_level(uint8_t level) {
+
+    this->pa_level = min(level, (uint8_t)RF24_PA_MAX);
+}
+
+
+void SimRadio::set_data_rate(uint8_t rate) {
+
+    this->data_rate = min(rate, (uint8_t)RF24_250KBPS);
+    this->restart_listening();
+}
+
+
+void SimRadio::set_retries(uint8_t delay, uint8_t count) {
+
+    this->retry_delay = min(delay, (uint8_t)15);
+    this->retry_count = min(count, (uint8_t)15);
+}
+
+
+void SimRadio::open_reading_pipe(uint8_t pipe, uint64_t address) {
+
+    if (SIM_RADIO_NUM_PIPES <= pipe) {
+        return;
+    }
+
+    this->pipe_addresses[pipe] = address;
+    this->open_pipes |= (1 << pipe);
+}
+
+
+void SimRadio::close_reading_pipe(uint8_t pipe) {
+
+    if (SIM_RADIO_NUM_PIPES <= pipe) {
+        return;
+    }
+
+    this->open_pipes &= ~(1 << pipe);
+}
+
+
+void SimRadio::open_writing_pipe(uint64_t address) {
+
+    this->tx_address = address;
+}
+
+
+void SimRadio::start_listening() {
+
+    // listening powers up the radio like the RF24 driver does
+    this->is_powered = true;
+    this->is_listening = true;
+
+    this->device->wait(RF24_SETTLE_US);
+    this->restart_listening();
+}
+
+
+void SimRadio::stop_listening() {
+
+    this->is_listening = false;
+}
+
+
+void SimRadio::power_up() {
+
+    this->is_powered = true;
+    this->restart_listening();
+}
+
+
+void SimRadio::power_down() {
+
+    this->is_powered = false;
+}
+
+
+bool SimRadio::test_carrier() {
+
+    return this->sim->get_medium()->is_carrier(this->channel, arduino_time_us);
+}
+
+
+bool SimRadio::available(uint8_t* pipe) {
+
+    // polling an empty radio takes time, unless a frame shows up
+    if (true == this->rx_fifo.empty()) {
+        this->device->wait(SIM_RADIO_POLL_US, true);
+    }
+
+    if (true == this->rx_fifo.empty()) {
+        return false;
+    }
+
+    if (NULL != pipe) {
+        *pipe = this->rx_fifo.front().pipe;
+    }
+
+    return true;
+}
+
+
+uint8_t SimRadio::get_payload_size() {
+
+    return (true == this->rx_fifo.empty()) ? 0 : this->rx_fifo.front().size;
+}
+
+
+void SimRadio::read(void* buffer, uint8_t size) {
+
+    if (true == this->rx_fifo.empty()) {
+        return;
+    }
+
+    const sim_frame_t& frame = this->rx_fifo.front();
+    memcpy(buffer, frame.payload, min(size, frame.size));
+
+    this->rx_fifo.pop_front();
+}
+
+
+bool SimRadio::write(const void* buffer, uint8_t size, bool is_multicast) {
+
+    this->num_retries = 0;
+
+    // radio has to be powered up to transmit
+    if (false == this->is_powered) {
+        this->device->wait(SIM_RADIO_TIMEOUT_US);
+        return false;
+    }
+
+    size = min(size, (uint8_t)SIM_RADIO_PAYLOAD_SIZE);
+    this->tx_pid = (this->tx_pid + 1) & 0x03;
+
+    RadioMedium* medium = this->sim->get_medium();
+    uint32_t rate_kbps = this->get_data_rate_kbps();
+
+    // multicast frames are sent once without waiting for an acknowledgement
+    uint8_t num_attempts = (true == is_multicast) ? 1 : (this->retry_count + 1);
+
+    for (uint8_t attempt = 0; attempt < num_attempts; attempt++) {
+
+        this->num_retries = attempt;
+        this->device->wait(RF24_SETTLE_US);
+
+        uint64_t start_us = arduino_time_us;
+        uint32_t frame_us = RadioMedium::get_airtime_us(size, rate_kbps);
+        uint32_t handle = medium->begin(this->channel, start_us, frame_us);
+
+        this->airtime_us += frame_us;
+        this->num_frames++;
+
+        this->device->wait(frame_us);
+
+        // frame arrived intact so every radio that could hear it is offered it
+        if (true == medium->end(handle)) {
+
+            SimRadio* receiver = this->sim->transmit(this->tx_address, this->channel, this->data_rate, start_us,
+                                                     (const uint8_t*)buffer, size, this->tx_pid,
+                                                     false == is_multicast);
+
+            if (true == is_multicast) {
+                return true;
+            }
+
+            // receiver sends its acknowledgement after turning around
+            if (NULL != receiver) {
+
+                this->device->wait(RF24_SETTLE_US);
+
+                uint32_t ack_us = RadioMedium::get_airtime_us(0, rate_kbps);
+                uint32_t ack_handle = medium->begin(this->channel, arduino_time_us, ack_us);
+                receiver->add_airtime(ack_us);
+
+                this->device->wait(ack_us);
+
+                if (true == medium->end(ack_handle)) {
+                    return true;
+                }
+            }
+        }
+
+        // nobody hears a multicast frame that was lost
+        if (true == is_multicast) {
+            return true;
+        }
+
+        // auto retransmit delay
+        this->device->wait(RF24_RETRY_STEP_US * (this->retry_delay + 1));
+    }
+
+    return false;
+}
+
+
+uint8_t SimRadio::get_retries() {
+
+    return this->num_retries;
+}
+
+
+bool SimRadio::receive(uint64_t address, uint8_t channel, uint8_t data_rate, uint64_t start_us,
+                       const uint8_t* buffer, uint8_t size, uint8_t pid, bool is_ack_expected) {
+
+    // radio has to receive on the channel for the whole frame
+    if (false == this->is_powered || false == this->is_listening || channel != this->channel
+        || data_rate != this->data_rate || start_us < this->listen_us) {
+
+        return false;
+    }
+
+    uint8_t pipe = 0;
+
+    while (SIM_RADIO_NUM_PIPES > pipe
+           && (0 == (this->open_pipes & (1 << pipe)) || address != this->pipe_addresses[pipe])) {
+
+        pipe++;
+    }
+
+    // frame is not for this radio
+    if (SIM_RADIO_NUM_PIPES == pipe) {
+        return false;
+    }
+
+    uint16_t crc = payload_crc(buffer, size);
+
+    // retransmission of a frame already received is acknowledged again but dropped
+    if (true == is_ack_expected && pid == this->rx_pids[pipe] && crc == this->rx_crcs[pipe]) {
+        return true;
+    }
+
+    // frames are neither stored nor acknowledged while the FIFO is full
+    if (SIM_RADIO_FIFO_SIZE <= this->rx_fifo.size()) {
+        return false;
+    }
+
+    sim_frame_t frame;
+    frame.pipe = pipe;
+    frame.size = size;
+    memcpy(frame.payload, buffer, size);
+
+    this->rx_fifo.push_back(frame);
+    this->rx_pids[pipe] = pid;
+    this->rx_crcs[pipe] = crc;
+
+    // sender is the device that is running
+    this->sim->record_frame(sim_device->get_id(), this->device->get_id(), buffer, size);
+    this->device->wake_on_frame();
+
+    return true;
+}
+
+
+void SimRadio::add_airtime(uint32_t duration_us) {
+
+    this->airtime_us += duration_us;
+}
+
+
+uint64_t SimRadio::get_airtime_us() {
+
+    return this->airtime_us;
+}
+
+
+uint32_t SimRadio::get_num_frames() {
+
+    return this->num_frames;
+}
+
+
+uint32_t SimRadio::get_data_rate_kbps() {
+
+    switch (this->data_rate) {
+
+        case RF24_2MBPS:
+            return 2000;
+
+        case RF24_250KBPS:
+            return 250;
+
+        default:
+            return 1000;
+    }
+}
@@ -0,0 +1,505 @@
+/**
+* @brief: Contains the implementation of the Simulator class.
+* @file: simulator.cpp
+*
+* @author: jkieltyka15
+*/
+
+// standard libraries
+#include <Arduino.h>
+#include <algorithm>
+
+// local libraries
+#include <Counters.h>
+#include <Layout.h>
+#include <Message.h>
+
+// local dependencies
+#include "uplink.hpp"
+#include "simulator.hpp"
+
+
+Simulator::Simulator(sim_config_t config) : config(config), rng(config.seed), medium(config.loss_rate, config.seed) {
+
+    memset(this->latest_changes, 0xFF, sizeof(this->latest_changes));
+    memset(this->sink_hops, 0, sizeof(this->sink_hops));
+    memset(this->host_statuses, 0xFF, sizeof(this->host_statuses));
+
+    // every device starts from the firmware's untouched globals, so all of
+    // them are constructed before any of them runs
+    for (uint8_t i = 0; i < LAYOUT_NUM_NODES; i++) {
+
+        uint8_t node_id = layout_nodes[i].node_id;
+        const sim_firmware_t* firmware = (true == layout_is_sink(node_id)) ? &sim_base_firmware : &sim_sensor_firmware;
+
+        this->devices[node_id].reset(new Device(this, firmware, node_id, config.seed + node_id));
+    }
+}
+
+
+uint32_t Simulator::schedule(uint8_t type, uint8_t node_id, uint64_t delay_us) {
+
+    uint32_t order = this->num_events++;
+    this->events.push({arduino_time_us + delay_us, order, type, node_id});
+
+    return order;
+}
+
+
+uint64_t Simulator::get_next_event_us() {
+
+    return (true == this->events.empty()) ? UINT64_MAX : this->events.top().time_us;
+}
+
+
+uint64_t Simulator::get_end_us() {
+
+    return this->end_us;
+}
+
+
+RadioMedium* Simulator::get_medium() {
+
+    return &this->medium;
+}
+
+
+void Simulator::schedule_arrival(uint8_t node_id) {
+
+    uint64_t interval_us = (uint64_t)this->config.interval_ms * 1000;
+    uint64_t settle_us = (uint64_t)SIM_SETTLE_MS * 1000;
+    uint64_t delay_us = interval_us;
+
+    // spaces start changing once the nodes reported their first status
+    uint64_t start_us = max(arduino_time_us, settle_us);
+    uint64_t offset_us = start_us - arduino_time_us;
+
+    switch (this->config.pattern) {
+
+        case SIM_PATTERN_POISSON:
+            delay_us = (uint64_t)std::exponential_distribution<double>(1.0 / interval_us)(this->rng);
+            break;
+
+        case SIM_PATTERN_PERIODIC:
+
+            // random phase so spaces do not change in lockstep
+            if (settle_us > arduino_time_us) {
+                delay_us = std::uniform_int_distribution<uint64_t>(0, interval_us - 1)(this->rng);
+            }
+
+            break;
+
+        case SIM_PATTERN_BURST:
+        {
+            uint64_t burst_us = (uint64_t)this->config.burst_ms * 1000;
+            uint64_t elapsed_us = start_us - settle_us;
+            uint64_t next_burst_us = ((elapsed_us / interval_us) + 1) * interval_us;
+
+            delay_us = next_burst_us - elapsed_us + std::uniform_int_distribution<uint64_t>(0, burst_us)(this->rng);
+            break;
+        }
+    }
+
+    (void) this->schedule(SIM_EVENT_ARRIVAL, node_id, offset_us + delay_us);
+}
+
+
+void Simulator::change_status(uint8_t node_id) {
+
+    int32_t latest = this->latest_changes[node_id];
+    bool is_vacant = true;
+
+    // change that has not reached the host yet is replaced by this one
+    if (0 <= latest) {
+
+        change_t* change = &this->changes[latest];
+        is_vacant = change->is_vacant;
+
+        if (false == change->is_delivered) {
+            change->is_superseded = true;
+        }
+    }
+
+    this->latest_changes[node_id] = (int32_t)this->changes.size();
+    this->changes.push_back({node_id, false == is_vacant, arduino_time_us, false, false});
+
+    this->devices[node_id]->set_occupied(true == is_vacant);
+}
+
+
+void Simulator::send_config() {
+
+    config_settings_t settings;
+    memset(&settings, CONFIG_KEEP, sizeof(settings));
+
+    if (0 != this->config.heartbeat_s) {
+        settings.heartbeat_interval_s = (uint8_t)this->config.heartbeat_s;
+    }
+
+    switch (this->config.data_rate_kbps) {
+
+        case 250:
+            settings.data_rate = RF24_250KBPS;
+            break;
+
+        case 1000:
+            settings.data_rate = RF24_1MBPS;
+            break;
+
+        case 2000:
+            settings.data_rate = RF24_2MBPS;
+            break;
+    }
+
+    // type, sequence number, target, version, settings, CRC
+    uint8_t frame[UPLINK_CONFIG_FRAME_SIZE];
+    frame[0] = UPLINK_CONFIG;
+    frame[1] = 0;
+    frame[2] = BROADCAST_ID;
+    frame[3] = CONFIG_VERSION_NONE + 1;
+    memcpy(&frame[4], &settings, sizeof(settings));
+    frame[sizeof(frame) - 1] = frame_crc(frame, sizeof(frame) - 1);
+
+    uint8_t encoded[COBS_ENCODED_SIZE(UPLINK_CONFIG_FRAME_SIZE) + 2];
+    encoded[0] = COBS_DELIMITER;
+
+    uint8_t size = 1 + cobs_encode(frame, sizeof(frame), &encoded[1]);
+    encoded[size++] = COBS_DELIMITER;
+
+    this->devices[LAYOUT_BASE_STATION_ID]->serial_send(encoded, size);
+}
+
+
+void Simulator::run() {
+
+    uint64_t duration_us = ((uint64_t)SIM_SETTLE_MS + this->config.duration_ms) * 1000;
+    this->end_us = duration_us + ((uint64_t)SIM_DRAIN_MS * 1000);
+
+    for (auto& device : this->devices) {
+
+        if (nullptr == device) {
+            continue;
+        }
+
+        device->start();
+
+        if (false == layout_is_sink(device->get_id())) {
+            this->schedule_arrival(device->get_id());
+        }
+    }
+
+    // host only configures what differs from the firmware
+    if (0 != this->config.data_rate_kbps || 0 != this->config.heartbeat_s) {
+        (void) this->schedule(SIM_EVENT_CONFIG, LAYOUT_BASE_STATION_ID, (uint64_t)SIM_CONFIG_MS * 1000);
+    }
+
+    while (false == this->events.empty() && this->end_us >= this->events.top().time_us) {
+
+        event_t event = this->events.top();
+        this->events.pop();
+
+        arduino_time_us = event.time_us;
+        Device* device = this->devices[event.node_id].get();
+
+        switch (event.type) {
+
+            case SIM_EVENT_WAKE:
+
+                // device was woken up again since this event was scheduled
+                if (event.order == device->get_wake_order()) {
+                    device->resume();
+                }
+
+                break;
+
+            case SIM_EVENT_ARRIVAL:
+
+                // parking spaces stop changing at the end so the network can drain
+                if (duration_us > arduino_time_us) {
+                    this->change_status(event.node_id);
+                    this->schedule_arrival(event.node_id);
+                }
+
+                break;
+
+            case SIM_EVENT_CONFIG:
+                this->send_config();
+                break;
+        }
+    }
+
+    arduino_time_us = this->end_us;
+}
+
+
+SimRadio* Simulator::transmit(uint64_t address, uint8_t channel, uint8_t data_rate, uint64_t start_us,
+                              const uint8_t* buffer, uint8_t size, uint8_t pid, bool is_ack_expected) {
+
+    SimRadio* receiver = NULL;
+
+    for (auto& device : this->devices) {
+
+        // sender does not hear itself
+        if (nullptr == device || device.get() == sim_device) {
+            continue;
+        }
+
+        if (true == device->radio.receive(address, channel, data_rate, start_us, buffer, size, pid, is_ack_expected)
+            && NULL == receiver) {
+
+            receiver = &device->radio;
+        }
+    }
+
+    return (true == is_ack_expected) ? receiver : NULL;
+}
+
+
+void Simulator::record_frame(uint8_t tx_id, uint8_t rx_id, const uint8_t* buffer, uint8_t size) {
+
+    uint8_t frame[MESSAGE_MAX_SIZE] = {0};
+    memcpy(frame, buffer, min(size, (uint8_t)MESSAGE_MAX_SIZE));
+
+    MessageView msg = MessageView(frame, size);
+
+    UpdateMessage* update_msg = msg.as_update();
+    AggregateMessage* aggregate_msg = msg.as_aggregate();
+
+    uint8_t num_statuses = 0;
+    uint8_t origins[AGGREGATE_MAX_ENTRIES];
+    uint8_t sequences[AGGREGATE_MAX_ENTRIES];
+
+    if (NULL != update_msg) {
+        origins[0] = update_msg->get_node_id();
+        sequences[0] = update_msg->get_sequence();
+        num_statuses = 1;
+    }
+
+    else if (NULL != aggregate_msg) {
+
+        num_statuses = min(aggregate_msg->get_num_entries(), (uint8_t)AGGREGATE_MAX_ENTRIES);
+
+        for (uint8_t i = 0; i < num_statuses; i++) {
+            origins[i] = aggregate_msg->get_node_id(i);
+            sequences[i] = aggregate_msg->get_sequence(i);
+        }
+    }
+
+    for (uint8_t i = 0; i < num_statuses; i++) {
+
+        uint32_t key = ((uint32_t)origins[i] << 8) | sequences[i];
+        uint8_t hops = 1;
+
+        // status was relayed, so it took one more hop than to the sender
+        if (tx_id != origins[i]) {
+
+            auto entry = this->status_hops.find(((uint32_t)tx_id << 16) | key);
+
+            if (this->status_hops.end() != entry) {
+                hops = entry->second + 1;
+            }
+        }
+
+        this->status_hops[((uint32_t)rx_id << 16) | key] = hops;
+
+        if (true == layout_is_sink(rx_id) && LAYOUT_MAX_NODE_ID >= origins[i]) {
+            this->sink_hops[origins[i]] = hops;
+        }
+    }
+}
+
+
+void Simulator::receive_serial(uint8_t node_id, const uint8_t* buffer, size_t size) {
+
+    // only the base station has a host attached
+    if (LAYOUT_BASE_STATION_ID != node_id) {
+        return;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+
+        if (COBS_DELIMITER != buffer[i]) {
+
+            // anything longer than a frame is text logged in between
+            if (UPLINK_MAX_ENCODED_SIZE > this->host_frame.size()) {
+                this->host_frame.push_back(buffer[i]);
+            }
+
+            continue;
+        }
+
+        if (false == this->host_frame.empty() && UPLINK_MAX_ENCODED_SIZE > this->host_frame.size()) {
+            this->handle_host_frame(this->host_frame.data(), (uint8_t)this->host_frame.size());
+        }
+
+        this->host_frame.clear();
+    }
+}
+
+
+void Simulator::handle_host_frame(uint8_t* frame, uint8_t size) {
+
+    size = cobs_decode(frame, size);
+
+    // frame must hold at least a type, sequence number and CRC
+    if (3 > size || frame[size - 1] != frame_crc(frame, size - 1)) {
+        return;
+    }
+
+    // stale statuses the base station has not heard from their node are not delivered
+    if (UPLINK_STATUS == frame[0] && 6 == size) {
+
+        if (0 != frame[4]) {
+            this->update_host_status(frame[2], 0 != frame[3]);
+        }
+    }
+
+    // number of nodes, vacancy bitmap and unconfirmed bitmap
+    else if (UPLINK_SNAPSHOT == frame[0] && 4 <= size && (4 + (2 * BITMAP_SIZE(frame[2]))) == size) {
+
+        uint8_t num_nodes = frame[2];
+        const uint8_t* vacancies = &frame[3];
+        const uint8_t* unconfirmed = &frame[3 + BITMAP_SIZE(num_nodes)];
+
+        // bit i of each bitmap is for node i + 1
+        for (uint8_t i = 0; i < num_nodes; i++) {
+
+            if (false == bitmap_get(unconfirmed, i)) {
+                this->update_host_status(i + 1, bitmap_get(vacancies, i));
+            }
+        }
+    }
+}
+
+
+void Simulator::update_host_status(uint8_t node_id, bool is_vacant) {
+
+    if (LAYOUT_MAX_NODE_ID < node_id || nullptr == this->devices[node_id]) {
+        return;
+    }
+
+    if ((int8_t)is_vacant != this->host_statuses[node_id]) {
+        this->host_statuses[node_id] = (int8_t)is_vacant;
+        this->num_host_updates++;
+    }
+
+    int32_t latest = this->latest_changes[node_id];
+
+    // only the latest change of a space can still be delivered
+    if (0 > latest || true == this->changes[latest].is_delivered || is_vacant != this->changes[latest].is_vacant) {
+        return;
+    }
+
+    change_t* change = &this->changes[latest];
+    change->is_delivered = true;
+
+    this->latencies_us.push_back((uint32_t)(arduino_time_us - change->changed_us));
+    this->hop_counts.push_back(this->sink_hops[node_id]);
+}
+
+
+/**
+ * @brief Gets a percentile of sorted values
+ * 
+ * @param values: values sorted in ascending order
+ * @param percent: percentile (0-100)
+ * @return Value at the percentile. Otherwise 0 if there are no values
+ */
+static uint32_t percentile(const std::vector<uint32_t>& values, uint8_t percent) {
+
+    if (true == values.empty()) {
+        return 0;
+    }
+
+    // nearest rank
+    size_t rank = ((values.size() * percent) + 99) / 100;
+
+    return values[(0 < rank) ? (rank - 1) : 0];
+}
+
+
+void Simulator::report(FILE* out) {
+
+    static const char* pattern_names[] = {"poisson", "periodic", "burst"};
+
+    double seconds = this->config.duration_ms / 1000.0;
+    double total_us = (double)arduino_time_us;
+
+    uint32_t num_delivered = 0;
+    uint32_t num_superseded = 0;
+
+    for (const change_t& change : this->changes) {
+
+        if (true == change.is_delivered) {
+            num_delivered++;
+        }
+
+        else if (true == change.is_superseded) {
+            num_superseded++;
+        }
+    }
+
+    uint32_t num_changes = (uint32_t)this->changes.size();
+    uint32_t num_lost = num_changes - num_delivered - num_superseded;
+
+    std::vector<uint32_t> latencies = this->latencies_us;
+    std::sort(latencies.begin(), latencies.end());
+
+    uint32_t max_hops = 0;
+    uint64_t sum_hops = 0;
+
+    for (uint8_t hops : this->hop_counts) {
+        sum_hops += hops;
+        max_hops = std::max(max_hops, (uint32_t)hops);
+    }
+
+    fprintf(out, "lot: %u sensor nodes, %.0f s of %s changes every %lu ms, loss %.3f",
+            (unsigned)(LAYOUT_NUM_NODES - layout_num_sinks()), seconds, pattern_names[this->config.pattern],
+            (unsigned long)this->config.interval_ms, this->config.loss_rate);
+
+    if (0 != this->config.data_rate_kbps) {
+        fprintf(out, ", configured %lu kbps", (unsigned long)this->config.data_rate_kbps);
+    }
+
+    if (0 != this->config.heartbeat_s) {
+        fprintf(out, ", configured heartbeat %lu s", (unsigned long)this->config.heartbeat_s);
+    }
+
+    fprintf(out, "\n");
+
+    fprintf(out, "changes: %lu generated, %lu delivered (%.1f%%), %lu superseded, %lu lost\n",
+            (unsigned long)num_changes, (unsigned long)num_delivered,
+            (0 < num_changes) ? (100.0 * num_delivered / num_changes) : 0.0,
+            (unsigned long)num_superseded, (unsigned long)num_lost);
+
+    fprintf(out, "throughput: %.2f delivered updates/s, %lu status updates seen by the host\n",
+            num_delivered / seconds, (unsigned long)this->num_host_updates);
+
+    fprintf(out, "latency ms: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+            percentile(latencies, 50) / 1000.0, percentile(latencies, 90) / 1000.0,
+            percentile(latencies, 99) / 1000.0, percentile(latencies, 100) / 1000.0);
+
+    fprintf(out, "hops: mean %.2f, max %lu\n",
+            (true == this->hop_counts.empty()) ? 0.0 : ((double)sum_hops / this->hop_counts.size()),
+            (unsigned long)max_hops);
+
+    fprintf(out, "\n node  airtime ms  duty %%  frames  attempts  retries  failures  busy  forwards  drops  overflows\n");
+
+    for (auto& device : this->devices) {
+
+        if (nullptr == device) {
+            continue;
+        }
+
+        uint16_t counters[NUM_COUNTERS] = {0};
+        device->read_global(counter_values, counters, sizeof(counters));
+
+        uint64_t airtime_us = device->radio.get_airtime_us();
+
+        fprintf(out, "%5u  %10.1f  %6.2f  %6lu  %8u  %7u  %8u  %4u  %8u  %5u  %9u\n",
+                (unsigned)device->get_id(), airtime_us / 1000.0, 100.0 * airtime_us / total_us,
+                (unsigned long)device->radio.get_num_frames(), counters[COUNTER_TX_ATTEMPTS],
+                counters[COUNTER_RETRIES], counters[COUNTER_TX_FAILURES], counters[COUNTER_CARRIER_BUSY],
+                counters[COUNTER_FORWARDS], counters[COUNTER_DROPS], counters[COUNTER_RX_OVERFLOWS]);
+    }
+}